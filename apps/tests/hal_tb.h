@@ -17,8 +17,13 @@ enum TestStatus {
     TEST_FAIL         = 0x7eadbeef,
 };
 
+// NVIC priority of test IRQs 0 and 1, which call MOS APIs
+#define HAL_TB_IRQ_PRIORITY  (MOS_MAX_SYSCALL_INT_PRIORITY >> (8 - __NVIC_PRIO_BITS))
+
 void MOS_ISR_SAFE IRQ0_Callback(void);
 void MOS_ISR_SAFE IRQ1_Callback(void);
+// Test IRQ 2 runs at highest priority and must not call MOS APIs
+void IRQ2_Callback(void);
 
 void HalTestsInit(void);
 void HalTestsTriggerInterrupt(u32 num);
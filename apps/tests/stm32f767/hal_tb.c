@@ -78,9 +78,17 @@ void EXTI1_IRQHandler(void) {
     IRQ1_Callback();
 }
 
+void EXTI2_IRQHandler(void) {
+    IRQ2_Callback();
+}
+
 void HalTestsInit(void) {
+    NVIC_SetPriority(EXTI0_IRQn, HAL_TB_IRQ_PRIORITY);
+    NVIC_SetPriority(EXTI1_IRQn, HAL_TB_IRQ_PRIORITY);
+    NVIC_SetPriority(EXTI2_IRQn, 0);
     NVIC_EnableIRQ(EXTI0_IRQn);
     NVIC_EnableIRQ(EXTI1_IRQn);
+    NVIC_EnableIRQ(EXTI2_IRQn);
 }
 
 void HalTestsTriggerInterrupt(u32 num) {
@@ -91,6 +99,9 @@ void HalTestsTriggerInterrupt(u32 num) {
     case 1:
         NVIC_SetPendingIRQ(EXTI1_IRQn);
         break;
+    case 2:
+        NVIC_SetPendingIRQ(EXTI2_IRQn);
+        break;
     default:
         break;
     }
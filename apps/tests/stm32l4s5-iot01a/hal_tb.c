@@ -25,9 +25,17 @@ void EXTI15_10_IRQHandler(void) {
     IRQ1_Callback();
 }
 
+void EXTI1_IRQHandler(void) {
+    IRQ2_Callback();
+}
+
 void HalTestsInit(void) {
+    NVIC_SetPriority(EXTI0_IRQn, HAL_TB_IRQ_PRIORITY);
+    NVIC_SetPriority(EXTI15_10_IRQn, HAL_TB_IRQ_PRIORITY);
+    NVIC_SetPriority(EXTI1_IRQn, 0);
     NVIC_EnableIRQ(EXTI0_IRQn);
     NVIC_EnableIRQ(EXTI15_10_IRQn);
+    NVIC_EnableIRQ(EXTI1_IRQn);
 }
 
 void HalTestsTriggerInterrupt(u32 num) {
@@ -38,6 +46,9 @@ void HalTestsTriggerInterrupt(u32 num) {
     case 1:
         NVIC_SetPendingIRQ(EXTI15_10_IRQn);
         break;
+    case 2:
+        NVIC_SetPendingIRQ(EXTI1_IRQn);
+        break;
     default:
         break;
     }
@@ -26,9 +26,17 @@ void EXTI10_IRQHandler(void) {
     IRQ1_Callback();
 }
 
+void EXTI1_IRQHandler(void) {
+    IRQ2_Callback();
+}
+
 void HalTestsInit(void) {
+    NVIC_SetPriority(EXTI0_IRQn, HAL_TB_IRQ_PRIORITY);
+    NVIC_SetPriority(EXTI10_IRQn, HAL_TB_IRQ_PRIORITY);
+    NVIC_SetPriority(EXTI1_IRQn, 0);
     NVIC_EnableIRQ(EXTI0_IRQn);
     NVIC_EnableIRQ(EXTI10_IRQn);
+    NVIC_EnableIRQ(EXTI1_IRQn);
 }
 
 void HalTestsTriggerInterrupt(u32 num) {
@@ -39,6 +47,9 @@ void HalTestsTriggerInterrupt(u32 num) {
     case 1:
         NVIC_SetPendingIRQ(EXTI10_IRQn);
         break;
+    case 2:
+        NVIC_SetPendingIRQ(EXTI1_IRQn);
+        break;
     default:
         break;
     }
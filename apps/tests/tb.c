@@ -14,6 +14,7 @@
 
 #include <mos/kernel.h>
 #include <mos/queue.h>
+#include <mos/stream.h>
 
 #include <mos/format_string.h>
 #include <mos/trace.h>
@@ -60,8 +61,12 @@ static volatile u32 SchedCount;
 
 // Test Sem / Mutex / Mux
 static MosSem TestSem;
+static MosEventGroup TestEventGroup;
 static MosMutex TestMutex;
-//static MosMutex TestMutex2;
+static MosCeilingMutex TestCeilingMutex;
+static MosRwLock TestRwLock;
+static MosCondVar TestCondVar;
+static MosMutex TestMutex2;
 
 // Test Message Queue
 static u32 queue[4];
@@ -98,6 +103,12 @@ void MOS_ISR_SAFE IRQ1_Callback(void) {
     if (mosTrySendToQueue32(&TestQueue, 1)) TestHisto[0]++;
 }
 
+static volatile bool ProbeFired;
+
+void IRQ2_Callback(void) {
+    ProbeFired = true;
+}
+
 void EventCallback(MosEvent evt, u32 val) {
     static u32 last_tick = 0;
     if (evt == MOS_EVENT_TICK) {
@@ -128,6 +139,88 @@ static s32 PriTestThread(s32 arg) {
     return TEST_PASS;
 }
 
+// Counts the number of times this thread was switched back in
+static s32 SliceTestThread(s32 arg) {
+    for (;;) {
+        if (IsStopRequested()) break;
+        if (TestFlag != (u32)arg) {
+            TestFlag = arg;
+            TestHisto[arg]++;
+        }
+    }
+    return TEST_PASS;
+}
+
+static s32 ThresholdTestThreadHi(s32 arg) {
+    TestFlag = 1;
+    return TEST_PASS;
+}
+
+// Starts a higher priority thread, which may only preempt if it is above
+//   the preemption threshold given by arg
+static s32 ThresholdTestThread(s32 arg) {
+    TestFlag = 0;
+    mosSetPreemptThreshold(mosGetRunningThread(), (MosThreadPriority)arg);
+    mosInitAndRunThread(Threads[2], 1, ThresholdTestThreadHi, 0, Stacks[2], DFT_STACK_SIZE);
+    u32 tick = mosGetTickCount();
+    while ((s32)(mosGetTickCount() - tick) < 2);
+    if (TestFlag != (arg == MOS_NO_PREEMPT_THRESHOLD ? 1 : 0)) return TEST_FAIL;
+    // Higher priority thread runs once this one blocks
+    mosDelayThread(1);
+    if (TestFlag != 1) return TEST_FAIL;
+    return TEST_PASS;
+}
+
+static s32 ThresholdBlockTestThread(s32 arg) {
+    mosDelayThread(1);
+    return TEST_PASS;
+}
+
+// Starts a thread held off by the threshold, then one above the threshold
+//   that preempts and blocks. The held off thread may not run meanwhile.
+static s32 ThresholdPreemptTestThread(s32 arg) {
+    TestFlag = 0;
+    mosSetPreemptThreshold(mosGetRunningThread(), 2);
+    mosInitAndRunThread(Threads[2], 2, ThresholdTestThreadHi, 0, Stacks[2], DFT_STACK_SIZE);
+    mosInitAndRunThread(Threads[3], 1, ThresholdBlockTestThread, 0, Stacks[3], DFT_STACK_SIZE);
+    u32 tick = mosGetTickCount();
+    while ((s32)(mosGetTickCount() - tick) < 3);
+    if (TestFlag != 0) return TEST_FAIL;
+    mosDelayThread(1);
+    if (TestFlag != 1) return TEST_FAIL;
+    return TEST_PASS;
+}
+
+#if (MOS_ENABLE_CPU_BUDGETS == true)
+
+static s32 BudgetTestThread(s32 arg) {
+    while (!IsStopRequested()) TestHisto[arg]++;
+    return TEST_PASS;
+}
+
+#endif
+
+#if (MOS_ENABLE_EDF == true)
+
+// Busy-waits, then records completion order
+static s32 EdfTestThread(s32 arg) {
+    mosDelayMicroseconds(5000);
+    TestHisto[TestFlag++] = arg;
+    // A passed deadline is only reported once
+    mosSetThreadDeadline(mosGetRunningThread(), mosGetTickCount() + 1000);
+    return TEST_PASS;
+}
+
+// Thread with earliest deadline waits for the next one to wake it
+static s32 EdfWakeTestThread(s32 arg) {
+    if (arg == 1) mosWaitForSem(&TestSem);
+    else if (arg == 2) mosIncrementSem(&TestSem);
+    TestHisto[TestFlag++] = arg;
+    return TEST_PASS;
+}
+
+#endif
+
 static s32 KillTestHandler(s32 arg) {
     mosPrint("KillTestHandler: Running Handler\n");
     if (mosIsMutexOwner(&TestMutex)) {
@@ -149,6 +242,18 @@ static s32 KillTestThread(s32 arg) {
     return TEST_FAIL;
 }
 
+static s32 KillNotifyTestThread(s32 arg) {
+    if (arg) {
+        // Notification delivered before the kill must not carry over
+        u32 val;
+        if (mosWaitForNotifyOrTO(0xffffffff, &val, 5)) return TEST_FAIL;
+        return TEST_PASS;
+    }
+    mosSetTermArg(mosGetRunningThread(), TEST_PASS_HANDLER);
+    mosWaitForNotify(0xffffffff);
+    return TEST_FAIL;
+}
+
 static s32 KillSelfTestThread(s32 arg) {
     if (arg) {
         mosSetTermHandler(mosGetRunningThread(), KillTestHandler, TEST_PASS_HANDLER);
@@ -348,6 +453,145 @@ static bool ThreadTests(void) {
         mosPrint(" Failed\n");
         tests_all_pass = false;
     }
+#if (MOS_ENABLE_EDF == true)
+    //
+    // Earliest deadline first
+    //
+    test_pass = true;
+    mosPrint("EDF Test\n");
+    ClearHistogram();
+    TestFlag = 0;
+    {
+        u32 misses = mosGetDeadlineMissCount();
+        static const u32 deadlines[3] = { 100, 50, 2 };
+        for (u32 ix = 0; ix < 3; ix++) {
+            mosInitThread(Threads[ix + 1], MOS_EDF_PRIORITY, EdfTestThread, deadlines[ix],
+                          Stacks[ix + 1], DFT_STACK_SIZE);
+            mosSetThreadDeadline(Threads[ix + 1], mosGetTickCount() + deadlines[ix]);
+        }
+        // Thread without a deadline runs last
+        mosInitThread(Threads[4], MOS_EDF_PRIORITY, EdfTestThread, 0, Stacks[4], DFT_STACK_SIZE);
+        for (u32 ix = 1; ix <= 4; ix++) mosRunThread(Threads[ix]);
+        for (u32 ix = 1; ix <= 4; ix++) {
+            if (mosWaitForThreadStop(Threads[ix]) != TEST_PASS) test_pass = false;
+        }
+        DisplayHistogram(4);
+        if (TestHisto[0] != 2 || TestHisto[1] != 50 || TestHisto[2] != 100 ||
+            TestHisto[3] != 0) test_pass = false;
+        // Thread with 2 tick deadline runs 5 msec
+        if (mosGetDeadlineMissCount() - misses != 1) test_pass = false;
+    }
+    // Waking thread with earlier deadline preempts running thread
+    ClearHistogram();
+    TestFlag = 0;
+    mosInitSem(&TestSem, 0);
+    for (u32 ix = 1; ix <= 2; ix++) {
+        mosInitThread(Threads[ix], MOS_EDF_PRIORITY, EdfWakeTestThread, ix, Stacks[ix], DFT_STACK_SIZE);
+        mosSetThreadDeadline(Threads[ix], mosGetTickCount() + 100 * ix);
+        mosRunThread(Threads[ix]);
+    }
+    for (u32 ix = 1; ix <= 2; ix++) {
+        if (mosWaitForThreadStop(Threads[ix]) != TEST_PASS) test_pass = false;
+    }
+    DisplayHistogram(2);
+    if (TestHisto[0] != 1 || TestHisto[1] != 2) test_pass = false;
+    if (test_pass) mosPrint(" Passed\n");
+    else {
+        mosPrint(" Failed\n");
+        tests_all_pass = false;
+    }
+#endif
+    //
+    // Time slicing
+    //
+    test_pass = true;
+    mosPrint("Time Slice Test\n");
+    ClearHistogram();
+    TestFlag = 2;
+    mosSetTimeSlice(1, 10);
+    mosInitAndRunThread(Threads[1], 1, SliceTestThread, 0, Stacks[1], DFT_STACK_SIZE);
+    mosInitAndRunThread(Threads[2], 1, SliceTestThread, 1, Stacks[2], DFT_STACK_SIZE);
+    mosDelayThread(500);
+    RequestThreadStop(Threads[1]);
+    RequestThreadStop(Threads[2]);
+    if (mosWaitForThreadStop(Threads[1]) != TEST_PASS) test_pass = false;
+    if (mosWaitForThreadStop(Threads[2]) != TEST_PASS) test_pass = false;
+    DisplayHistogram(2);
+    // Expect a switch about every 10 ticks
+    if (TestHisto[0] < 20 || TestHisto[0] > 30) test_pass = false;
+    if (TestHisto[1] < 20 || TestHisto[1] > 30) test_pass = false;
+    // No slicing, first thread runs until it stops
+    ClearHistogram();
+    TestFlag = 2;
+    mosSetTimeSlice(1, 0);
+    mosInitAndRunThread(Threads[1], 1, SliceTestThread, 0, Stacks[1], DFT_STACK_SIZE);
+    mosInitAndRunThread(Threads[2], 1, SliceTestThread, 1, Stacks[2], DFT_STACK_SIZE);
+    mosDelayThread(100);
+    RequestThreadStop(Threads[1]);
+    RequestThreadStop(Threads[2]);
+    if (mosWaitForThreadStop(Threads[1]) != TEST_PASS) test_pass = false;
+    if (mosWaitForThreadStop(Threads[2]) != TEST_PASS) test_pass = false;
+    DisplayHistogram(2);
+    if (TestHisto[0] != 1 || TestHisto[1] != 0) test_pass = false;
+    mosSetTimeSlice(1, MOS_DEFAULT_TIME_SLICE);
+    if (test_pass) mosPrint(" Passed\n");
+    else {
+        mosPrint(" Failed\n");
+        tests_all_pass = false;
+    }
+    //
+    // Preemption Threshold
+    //
+    test_pass = true;
+    mosPrint("Preemption Threshold Test\n");
+    mosInitAndRunThread(Threads[1], 2, ThresholdTestThread, MOS_NO_PREEMPT_THRESHOLD,
+                        Stacks[1], DFT_STACK_SIZE);
+    if (mosWaitForThreadStop(Threads[1]) != TEST_PASS) test_pass = false;
+    mosWaitForThreadStop(Threads[2]);
+    mosInitAndRunThread(Threads[1], 2, ThresholdTestThread, 1, Stacks[1], DFT_STACK_SIZE);
+    if (mosWaitForThreadStop(Threads[1]) != TEST_PASS) test_pass = false;
+    mosWaitForThreadStop(Threads[2]);
+    // Threshold still applies after a preempting thread blocks
+    mosInitAndRunThread(Threads[1], 3, ThresholdPreemptTestThread, 0, Stacks[1], DFT_STACK_SIZE);
+    if (mosWaitForThreadStop(Threads[1]) != TEST_PASS) test_pass = false;
+    mosWaitForThreadStop(Threads[2]);
+    mosWaitForThreadStop(Threads[3]);
+    if (test_pass) mosPrint(" Passed\n");
+    else {
+        mosPrint(" Failed\n");
+        tests_all_pass = false;
+    }
+#if (MOS_ENABLE_CPU_BUDGETS == true)
+    //
+    // CPU Budget
+    //
+    test_pass = true;
+    mosPrint("CPU Budget Test\n");
+    ClearHistogram();
+    {
+        // Limit high priority thread to a quarter of each 10 tick period
+        u64 start = mosGetCycleCount();
+        mosDelayThread(10);
+        u32 cycles = (u32)(mosGetCycleCount() - start);
+        mosInitThread(Threads[1], 1, BudgetTestThread, 0, Stacks[1], DFT_STACK_SIZE);
+        mosSetThreadBudget(Threads[1], cycles / 4, 10);
+        mosRunThread(Threads[1]);
+        mosInitAndRunThread(Threads[2], 2, BudgetTestThread, 1, Stacks[2], DFT_STACK_SIZE);
+        mosDelayThread(200);
+        RequestThreadStop(Threads[1]);
+        RequestThreadStop(Threads[2]);
+        if (mosWaitForThreadStop(Threads[1]) != TEST_PASS) test_pass = false;
+        if (mosWaitForThreadStop(Threads[2]) != TEST_PASS) test_pass = false;
+        DisplayHistogram(2);
+        // Lower priority thread should get about three times the CPU
+        if (TestHisto[0] == 0 || TestHisto[1] < 2 * TestHisto[0]) test_pass = false;
+    }
+    if (test_pass) mosPrint(" Passed\n");
+    else {
+        mosPrint(" Failed\n");
+        tests_all_pass = false;
+    }
+#endif
     //
     // Thread Storage
     //
@@ -430,6 +674,24 @@ static bool ThreadTests(void) {
         tests_all_pass = false;
     }
     //
+    // Kill thread that was just notified (notification still queued)
+    //
+    test_pass = true;
+    mosPrint("Kill Test 4\n");
+    ClearHistogram();
+    mosInitAndRunThread(Threads[1], 1, KillNotifyTestThread, 0, Stacks[1], DFT_STACK_SIZE);
+    mosDelayThread(10);
+    mosNotifyThread(Threads[1], 1, MOS_NOTIFY_SET_BITS);
+    mosKillThread(Threads[1]);
+    if (mosWaitForThreadStop(Threads[1]) != TEST_PASS_HANDLER) test_pass = false;
+    mosInitAndRunThread(Threads[1], 1, KillNotifyTestThread, 1, Stacks[1], DFT_STACK_SIZE);
+    if (mosWaitForThreadStop(Threads[1]) != TEST_PASS) test_pass = false;
+    if (test_pass) mosPrint(" Passed\n");
+    else {
+        mosPrint(" Failed\n");
+        tests_all_pass = false;
+    }
+    //
     // Assertion/Exception test
     //
     test_pass = true;
@@ -551,6 +813,31 @@ static s32 MessageTimerTestThread(s32 arg) {
 //
 // Timer Tests
 //
+static u32 WheelTestStart;
+
+// Records tick (relative to start of test) at which timer fired
+static bool MOS_ISR_SAFE WheelTimerCallback(MosTimer * pTmr) {
+    TestHisto[(u32)pTmr->pUser] = mosGetTickCount() - WheelTestStart;
+    return true;
+}
+
+// Periodic thread doing a variable amount of work, must not drift
+static s32 PeriodicTestThread(s32 arg) {
+    MosPeriodic per;
+    mosInitPeriodic(&per, timer_test_delay);
+    u32 start = per.lastRelease;
+    for (u32 ix = 0; ix < 20; ix++) {
+        mosDelayMicroseconds((ix % 5) * 1000);
+        if (ix == 10 && arg) mosDelayThread(timer_test_delay + 5);
+        mosWaitForNextPeriod(&per);
+    }
+    mosPrintf(" Releases %u Overruns %u Jitter %u (max %u) cycles\n",
+              per.releaseCount, per.overrunCount, per.lastJitter, per.maxJitter);
+    TestHisto[0] = per.overrunCount;
+    TestHisto[1] = per.lastRelease - start;
+    return TEST_PASS;
+}
+
 static bool TimerTests(void) {
     const u32 test_time = 5000;
     u32 exp_iter = test_time / timer_test_delay;
@@ -580,6 +867,29 @@ static bool TimerTests(void) {
         tests_all_pass = false;
     }
     //
+    // Drift-free periodic release
+    //
+    test_pass = true;
+    mosPrint("Periodic Test\n");
+    ClearHistogram();
+    mosInitAndRunThread(Threads[1], 1, PeriodicTestThread, 0, Stacks[1], DFT_STACK_SIZE);
+    if (mosWaitForThreadStop(Threads[1]) != TEST_PASS) test_pass = false;
+    if (TestHisto[0] != 0 || TestHisto[1] != 20 * timer_test_delay) test_pass = false;
+    // Overrun restarts period
+    ClearHistogram();
+    mosInitAndRunThread(Threads[1], 1, PeriodicTestThread, 1, Stacks[1], DFT_STACK_SIZE);
+    if (mosWaitForThreadStop(Threads[1]) != TEST_PASS) test_pass = false;
+    if (TestHisto[0] != 1) test_pass = false;
+    {
+        u32 delta = TestHisto[1] - 20 * timer_test_delay;
+        if (delta == 0 || delta > timer_test_delay) test_pass = false;
+    }
+    if (test_pass) mosPrint(" Passed\n");
+    else {
+        mosPrint(" Failed\n");
+        tests_all_pass = false;
+    }
+    //
     // Run uniform timers
     //
     test_pass = true;
@@ -702,6 +1012,45 @@ static bool TimerTests(void) {
         tests_all_pass = false;
     }
     //
+    // Long timeouts cascade down the timing wheel levels (and from the
+    //   overflow queue), cancelled timers never fire. The tick count is
+    //   skipped ahead so the test takes little time.
+    //
+    test_pass = true;
+    mosPrint("Timer Wheel Test\n");
+    ClearHistogram();
+    {
+        static const u32 delays[] = { 3, 45, 1100, 5000, 40000 };
+        static MosTimer tmrs[count_of(delays) + 1];
+        const u32 step = 20;
+        const u32 cancelled = count_of(delays);
+        WheelTestStart = mosGetTickCount();
+        for (u32 ix = 0; ix < count_of(delays); ix++) {
+            mosInitTimer(&tmrs[ix], WheelTimerCallback);
+            mosSetTimer(&tmrs[ix], delays[ix], (void *)ix);
+        }
+        mosInitTimer(&tmrs[cancelled], WheelTimerCallback);
+        mosSetTimer(&tmrs[cancelled], 2000, (void *)cancelled);
+        mosDelayThread(100);
+        mosCancelTimer(&tmrs[cancelled]);
+        while (mosGetTickCount() - WheelTestStart < 40000 + 2 * step) {
+            mosAdvanceTickCount(step);
+            mosDelayThread(1);
+        }
+        DisplayHistogram(count_of(tmrs));
+        // Each timer fires no earlier than its expiry, and within a step of it
+        for (u32 ix = 0; ix < count_of(delays); ix++) {
+            if (TestHisto[ix] < delays[ix] || TestHisto[ix] > delays[ix] + step + 2)
+                test_pass = false;
+        }
+        if (TestHisto[cancelled] != 0) test_pass = false;
+    }
+    if (test_pass) mosPrint(" Passed\n");
+    else {
+        mosPrint(" Failed\n");
+        tests_all_pass = false;
+    }
+    //
     // User timers 1
     //
     test_pass = true;
@@ -781,6 +1130,59 @@ static s32 SemTestThreadRx(s32 arg) {
     return TEST_PASS;
 }
 
+static s32 NotifyTestThreadTx(s32 arg) {
+    for (;;) {
+        mosNotifyThread(Threads[1], 0, MOS_NOTIFY_INCREMENT);
+        TestHisto[arg]++;
+        mosDelayThread(sem_test_delay);
+        if (IsStopRequested()) break;
+    }
+    return TEST_PASS;
+}
+
+static s32 NotifyTestThreadRx(s32 arg) {
+    for (;;) {
+        u32 val;
+        if (mosWaitForNotifyOrTO(0xffffffff, &val, sem_test_delay / 2 + 10)) {
+            TestHisto[arg] += val;
+        } else {
+            TestHisto[arg + 1]++;
+        }
+        if (IsStopRequested()) break;
+    }
+    return TEST_PASS;
+}
+
+static s32 EventGroupTestThreadTx(s32 arg) {
+    for (;;) {
+        mosSetEventFlags(&TestEventGroup, 0x1);
+        mosSetEventFlags(&TestEventGroup, 0x2);
+        mosSetEventFlags(&TestEventGroup, 0x4);
+        TestHisto[arg]++;
+        mosDelayThread(sem_test_delay);
+        if (IsStopRequested()) break;
+    }
+    return TEST_PASS;
+}
+
+// Two threads wait for any of 0x1, one waits for all of 0x6 with timeout
+static s32 EventGroupTestThreadRx(s32 arg) {
+    for (;;) {
+        if (arg < 2) {
+            if (mosWaitForEventFlags(&TestEventGroup, 0x1, MOS_EVENT_GROUP_AUTO_CLEAR) == 0x1)
+                TestHisto[arg]++;
+        } else {
+            u32 flags = mosWaitForEventFlagsOrTO(&TestEventGroup, 0x6,
+                            MOS_EVENT_GROUP_WAIT_ALL | MOS_EVENT_GROUP_AUTO_CLEAR,
+                            sem_test_delay / 2 + 10);
+            if (flags == 0x6) TestHisto[arg]++;
+            else if (flags == 0) TestHisto[arg + 2]++;
+        }
+        if (IsStopRequested()) break;
+    }
+    return TEST_PASS;
+}
+
 static s32 SemTestThreadRxTimeout(s32 arg) {
     for (;;) {
         if (mosWaitForSemOrTO(&TestSem, sem_test_delay / 2 + 10)) {
@@ -838,6 +1240,19 @@ static s32 SignalTestThreadRxTimeout(s32 arg) {
     return TEST_PASS;
 }
 
+// Records order in which threads are released from the semaphore
+static s32 SemOrderTestThread(s32 arg) {
+    mosWaitForSem(&TestSem);
+    TestHisto[TestFlag++] = arg;
+    return TEST_PASS;
+}
+
+// Runs in scheduler context, counts invocations and wakes the waiting thread
+static void TestISREventHandler(MosISREvent * pEvt) {
+    TestHisto[0]++;
+    mosIncrementSem((MosSem *)pEvt->pUser);
+}
+
 static s32 SignalTestPoll(s32 arg) {
     for (;;) {
         u32 flags = mosPollSignal(&TestSem);
@@ -962,6 +1377,102 @@ static bool SemTests(void) {
         tests_all_pass = false;
     }
     //
+    // Waiters are released by priority, then in order of arrival
+    //
+    test_pass = true;
+    mosPrint("Sem Priority Order\n");
+    ClearHistogram();
+    TestFlag = 0;
+    mosInitSem(&TestSem, 0);
+    mosInitAndRunThread(Threads[1], 4, SemOrderTestThread, 4, Stacks[1], DFT_STACK_SIZE);
+    mosInitAndRunThread(Threads[2], 2, SemOrderTestThread, 2, Stacks[2], DFT_STACK_SIZE);
+    mosInitAndRunThread(Threads[3], 3, SemOrderTestThread, 3, Stacks[3], DFT_STACK_SIZE);
+    mosInitAndRunThread(Threads[4], 2, SemOrderTestThread, 5, Stacks[4], DFT_STACK_SIZE);
+    mosDelayThread(2);
+    for (u32 ix = 0; ix < 4; ix++) {
+        mosIncrementSem(&TestSem);
+        mosDelayThread(1);
+    }
+    for (u32 ix = 1; ix <= 4; ix++) {
+        if (mosWaitForThreadStop(Threads[ix]) != TEST_PASS) test_pass = false;
+    }
+    DisplayHistogram(4);
+    if (TestHisto[0] != 2 || TestHisto[1] != 5 || TestHisto[2] != 3 || TestHisto[3] != 4)
+        test_pass = false;
+    if (test_pass) mosPrint(" Passed\n");
+    else {
+        mosPrint(" Failed\n");
+        tests_all_pass = false;
+    }
+    //
+    // Re-prioritized waiters move between priorities of the pend queue
+    //   (exercises bucket tail hand-off with MOS_PEND_QUEUE_BUCKETS)
+    //
+    test_pass = true;
+    mosPrint("Sem Pend Queue Reorder\n");
+    ClearHistogram();
+    TestFlag = 0;
+    mosInitSem(&TestSem, 0);
+    mosInitAndRunThread(Threads[1], 3, SemOrderTestThread, 1, Stacks[1], DFT_STACK_SIZE);
+    mosInitAndRunThread(Threads[2], 2, SemOrderTestThread, 2, Stacks[2], DFT_STACK_SIZE);
+    mosInitAndRunThread(Threads[3], 3, SemOrderTestThread, 3, Stacks[3], DFT_STACK_SIZE);
+    mosInitAndRunThread(Threads[4], 3, SemOrderTestThread, 4, Stacks[4], DFT_STACK_SIZE);
+    mosDelayThread(2);
+    // Middle of priority 3 moves to end of priority 2, then the last
+    //   of priority 3 drops to priority 4
+    mosChangeThreadPriority(Threads[3], 2);
+    mosChangeThreadPriority(Threads[4], 4);
+    for (u32 ix = 0; ix < 4; ix++) {
+        mosIncrementSem(&TestSem);
+        mosDelayThread(1);
+    }
+    for (u32 ix = 1; ix <= 4; ix++) {
+        if (mosWaitForThreadStop(Threads[ix]) != TEST_PASS) test_pass = false;
+    }
+    DisplayHistogram(4);
+    if (TestHisto[0] != 2 || TestHisto[1] != 3 || TestHisto[2] != 1 || TestHisto[3] != 4)
+        test_pass = false;
+    if (test_pass) mosPrint(" Passed\n");
+    else {
+        mosPrint(" Failed\n");
+        tests_all_pass = false;
+    }
+    //
+    // A burst of gives releases as many waiters as the count allows
+    //
+    test_pass = true;
+    mosPrint("Sem ISR Burst\n");
+    ClearHistogram();
+    TestFlag = 0;
+    mosInitSem(&TestSem, 0);
+    for (u32 ix = 1; ix <= 4; ix++)
+        mosInitAndRunThread(Threads[ix], 2, SemOrderTestThread, ix, Stacks[ix], DFT_STACK_SIZE);
+    mosDelayThread(2);
+    mosResetISREventStats();
+    {
+        // Simulate ISR giving semaphore repeatedly before scheduler runs
+        u32 mask = mosDisableInterrupts();
+        for (u32 ix = 0; ix < 4; ix++) mosIncrementSem(&TestSem);
+        mosEnableInterrupts(mask);
+    }
+    mosDelayThread(2);
+    if (TestFlag != 4) test_pass = false;
+    for (u32 ix = 1; ix <= 4; ix++) {
+        if (mosWaitForThreadStop(Threads[ix]) != TEST_PASS) test_pass = false;
+        if (TestHisto[ix - 1] != ix) test_pass = false;
+    }
+    {
+        u32 batch, cycles;
+        mosGetISREventStats(&batch, &cycles);
+        mosPrintf(" Max batch = %u, Max int lock = %u cycles\n", batch, cycles);
+        if (batch != 1) test_pass = false;
+    }
+    if (test_pass) mosPrint(" Passed\n");
+    else {
+        mosPrint(" Failed\n");
+        tests_all_pass = false;
+    }
+    //
     // TrySem
     //
     test_pass = true;
@@ -1063,12 +1574,96 @@ static bool SemTests(void) {
         mosPrint(" Failed\n");
         tests_all_pass = false;
     }
-    return tests_all_pass;
-}
-
-//
-// Queue Testing
-//
+    //
+    // Event groups with multiple waiters
+    //
+    test_pass = true;
+    mosPrint("Event Group Test\n");
+    ClearHistogram();
+    mosInitEventGroup(&TestEventGroup, 0);
+    mosInitAndRunThread(Threads[1], 1, EventGroupTestThreadRx, 0, Stacks[1], DFT_STACK_SIZE);
+    mosInitAndRunThread(Threads[2], 2, EventGroupTestThreadRx, 1, Stacks[2], DFT_STACK_SIZE);
+    mosInitAndRunThread(Threads[3], 2, EventGroupTestThreadRx, 2, Stacks[3], DFT_STACK_SIZE);
+    mosInitAndRunThread(Threads[4], 3, EventGroupTestThreadTx, 3, Stacks[4], DFT_STACK_SIZE);
+    mosDelayThread(test_time);
+    RequestThreadStop(Threads[4]);
+    if (mosWaitForThreadStop(Threads[4]) != TEST_PASS) test_pass = false;
+    RequestThreadStop(Threads[1]);
+    RequestThreadStop(Threads[2]);
+    RequestThreadStop(Threads[3]);
+    mosSetEventFlags(&TestEventGroup, 0x7); // Unblock threads to stop
+    if (mosWaitForThreadStop(Threads[1]) != TEST_PASS) test_pass = false;
+    if (mosWaitForThreadStop(Threads[2]) != TEST_PASS) test_pass = false;
+    if (mosWaitForThreadStop(Threads[3]) != TEST_PASS) test_pass = false;
+    DisplayHistogram(5);
+    if (TestHisto[0] != TestHisto[3] + 1) test_pass = false;
+    if (TestHisto[1] != TestHisto[3] + 1) test_pass = false;
+    if (TestHisto[2] != TestHisto[3] + 1) test_pass = false;
+    if (TestHisto[4] == 0) test_pass = false;
+    if (mosGetEventFlags(&TestEventGroup) != 0) test_pass = false;
+    if (test_pass) mosPrint(" Passed\n");
+    else {
+        mosPrint(" Failed\n");
+        tests_all_pass = false;
+    }
+    //
+    // Thread notifications with timeouts
+    //
+    test_pass = true;
+    mosPrint("Notify Test\n");
+    ClearHistogram();
+    mosInitAndRunThread(Threads[1], 1, NotifyTestThreadRx, 2, Stacks[1], DFT_STACK_SIZE);
+    mosInitAndRunThread(Threads[2], 2, NotifyTestThreadTx, 0, Stacks[2], DFT_STACK_SIZE);
+    mosInitAndRunThread(Threads[3], 3, NotifyTestThreadTx, 1, Stacks[3], DFT_STACK_SIZE);
+    mosDelayThread(test_time);
+    RequestThreadStop(Threads[2]);
+    RequestThreadStop(Threads[3]);
+    if (mosWaitForThreadStop(Threads[2]) != TEST_PASS) test_pass = false;
+    if (mosWaitForThreadStop(Threads[3]) != TEST_PASS) test_pass = false;
+    // Receiver exits on next timeout after stop request
+    RequestThreadStop(Threads[1]);
+    if (mosWaitForThreadStop(Threads[1]) != TEST_PASS) test_pass = false;
+    DisplayHistogram(4);
+    if (TestHisto[2] != TestHisto[0] + TestHisto[1]) test_pass = false;
+    if (TestHisto[3] == 0) test_pass = false;
+    if (test_pass) mosPrint(" Passed\n");
+    else {
+        mosPrint(" Failed\n");
+        tests_all_pass = false;
+    }
+    //
+    // ISR events are handled once per posting by the scheduler
+    //
+    test_pass = true;
+    mosPrint("ISR Event Test\n");
+    ClearHistogram();
+    {
+        MosISREvent evt;
+        mosInitISREvent(&evt, TestISREventHandler);
+        evt.pUser = &TestSem;
+        mosInitSem(&TestSem, 0);
+        // Simulate ISR posting repeatedly before scheduler runs
+        u32 mask = mosDisableInterrupts();
+        mosPostISREvent(&evt);
+        mosPostISREvent(&evt);
+        mosEnableInterrupts(mask);
+        if (!mosWaitForSemOrTO(&TestSem, 10)) test_pass = false;
+        if (TestHisto[0] != 1) test_pass = false;
+        mosPostISREvent(&evt);
+        if (!mosWaitForSemOrTO(&TestSem, 10)) test_pass = false;
+        if (TestHisto[0] != 2) test_pass = false;
+    }
+    if (test_pass) mosPrint(" Passed\n");
+    else {
+        mosPrint(" Failed\n");
+        tests_all_pass = false;
+    }
+    return tests_all_pass;
+}
+
+//
+// Queue Testing
+//
 
 static const u32 queue_test_delay = 50;
 
@@ -1148,6 +1743,24 @@ static s32 QueueTestThreadRxTimeout(s32 arg) {
     return TEST_PASS;
 }
 
+static MosStreamBuffer TestStream;
+static MosMessageBuffer TestMsgBuf;
+static u8 StreamBuf[16];
+
+static s32 StreamTestThreadRx(s32 arg) {
+    u8 buf[8];
+    TestHisto[0] = mosReadFromStreamBuffer(&TestStream, buf, sizeof(buf));
+    return TEST_PASS;
+}
+
+static s32 QueueTestThreadRxMany(s32 arg) {
+    u32 buf[4];
+    u32 count = mosReceiveManyFromQueue(&TestQueue, buf, count_of(buf));
+    TestHisto[0] = count;
+    for (u32 ix = 0; ix < count; ix++) TestHisto[ix + 1] = buf[ix];
+    return TEST_PASS;
+}
+
 static bool QueueTests(void) {
     const u32 test_time = 5000;
     u32 exp_cnt = test_time / queue_test_delay;
@@ -1266,6 +1879,204 @@ static bool QueueTests(void) {
         mosPrint(" Failed\n");
         tests_all_pass = false;
     }
+    //
+    // Zero-copy reserve / commit and peek / release
+    //
+    test_pass = true;
+    mosPrint("Queue Test 5\n");
+    mosInitQueue32(&TestQueue, queue, count_of(queue));
+    {
+        u32 * pSlot0 = mosReserveQueueSlot(&TestQueue);
+        u32 * pSlot1 = mosTryReserveQueueSlot(&TestQueue);
+        if (pSlot0 == NULL || pSlot1 == NULL || pSlot1 == pSlot0) test_pass = false;
+        else {
+            // Nothing is visible to readers until both reservations commit
+            *pSlot1 = 11;
+            mosCommitQueueSlot(&TestQueue);
+            if (mosTryPeekQueue(&TestQueue) != NULL) test_pass = false;
+            *pSlot0 = 10;
+            mosCommitQueueSlot(&TestQueue);
+            u32 * pPeek = mosPeekQueueOrTO(&TestQueue, 10);
+            if (pPeek != pSlot0 || *pPeek != 10) test_pass = false;
+            mosReleaseQueueSlot(&TestQueue);
+            if (mosReceiveFromQueue32(&TestQueue) != 11) test_pass = false;
+            if (mosTryPeekQueue(&TestQueue) != NULL) test_pass = false;
+        }
+        // Fill queue in place, then drain in place
+        for (u32 ix = 0; ix < count_of(queue); ix++) {
+            u32 * pSlot = mosTryReserveQueueSlot(&TestQueue);
+            if (pSlot == NULL) test_pass = false;
+            else {
+                *pSlot = ix;
+                mosCommitQueueSlot(&TestQueue);
+            }
+        }
+        if (mosReserveQueueSlotOrTO(&TestQueue, 10) != NULL) test_pass = false;
+        for (u32 ix = 0; ix < count_of(queue); ix++) {
+            u32 * pSlot = mosTryPeekQueue(&TestQueue);
+            if (pSlot == NULL || *pSlot != ix) test_pass = false;
+            if (pSlot) mosReleaseQueueSlot(&TestQueue);
+        }
+    }
+    if (TestQueue.pHead != TestQueue.pTail) test_pass = false;
+    if (test_pass) mosPrint(" Passed\n");
+    else {
+        mosPrint(" Failed\n");
+        tests_all_pass = false;
+    }
+    //
+    // Batched send / receive
+    //
+    test_pass = true;
+    mosPrint("Queue Test 6\n");
+    ClearHistogram();
+    mosInitQueue32(&TestQueue, queue, count_of(queue));
+    {
+        u32 buf[6] = { 0, 1, 2, 3, 4, 5 };
+        u32 rx[6];
+        // Offset ring so that batches wrap
+        for (u32 ix = 0; ix < 3; ix++) {
+            mosSendToQueue32(&TestQueue, ix);
+            mosReceiveFromQueue32(&TestQueue);
+        }
+        if (mosTrySendManyToQueue(&TestQueue, buf, count_of(buf)) != count_of(queue)) test_pass = false;
+        if (mosTrySendManyToQueue(&TestQueue, buf, count_of(buf)) != 0) test_pass = false;
+        if (mosSendManyToQueueOrTO(&TestQueue, buf, count_of(buf), 10) != 0) test_pass = false;
+        if (mosReceiveManyFromQueueOrTO(&TestQueue, rx, 3, 10) != 3) test_pass = false;
+        if (mosTryReceiveManyFromQueue(&TestQueue, &rx[3], 3) != 1) test_pass = false;
+        for (u32 ix = 0; ix < count_of(queue); ix++) {
+            if (rx[ix] != ix) test_pass = false;
+        }
+        if (mosReceiveManyFromQueueOrTO(&TestQueue, rx, 3, 10) != 0) test_pass = false;
+        // Blocked receiver takes a whole batch in one call
+        mosInitAndRunThread(Threads[1], 1, QueueTestThreadRxMany, 0, Stacks[1], DFT_STACK_SIZE);
+        mosDelayThread(10);
+        if (mosSendManyToQueue(&TestQueue, &buf[1], 3) != 3) test_pass = false;
+        if (mosWaitForThreadStop(Threads[1]) != TEST_PASS) test_pass = false;
+        if (TestHisto[0] != 3) test_pass = false;
+        for (u32 ix = 1; ix <= 3; ix++) {
+            if (TestHisto[ix] != ix) test_pass = false;
+        }
+    }
+    if (TestQueue.pHead != TestQueue.pTail) test_pass = false;
+    if (test_pass) mosPrint(" Passed\n");
+    else {
+        mosPrint(" Failed\n");
+        tests_all_pass = false;
+    }
+    //
+    // Stream buffer
+    //
+    test_pass = true;
+    mosPrint("Stream Buffer Test\n");
+    ClearHistogram();
+    mosInitStreamBuffer(&TestStream, StreamBuf, sizeof(StreamBuf), 4);
+    {
+        const char * pText = "0123456789abcdefghij";
+        char rx[20];
+        // Wrapping write and read, stream holds one less than buffer size
+        if (mosTryWriteToStreamBuffer(&TestStream, pText, 10) != 10) test_pass = false;
+        if (mosTryReadFromStreamBuffer(&TestStream, rx, 10) != 10) test_pass = false;
+        if (mosTryWriteToStreamBuffer(&TestStream, pText, 20) != 15) test_pass = false;
+        if (mosGetStreamBufferSpace(&TestStream) != 0) test_pass = false;
+        if (mosWriteToStreamBufferOrTO(&TestStream, pText, 1, 10) != 0) test_pass = false;
+        if (mosReadFromStreamBufferOrTO(&TestStream, rx, 20, 10) != 15) test_pass = false;
+        if (memcmp(rx, pText, 15) != 0) test_pass = false;
+        // Contiguous regions stop at end of ring
+        void * pWr;
+        const void * pRd;
+        u32 size = mosGetStreamBufferWriteRegion(&TestStream, &pWr);
+        if (size != sizeof(StreamBuf) - 9) test_pass = false;
+        memcpy(pWr, pText, 3);
+        mosCommitStreamBufferWrite(&TestStream, 3);
+        if (mosGetStreamBufferReadRegion(&TestStream, &pRd) != 3) test_pass = false;
+        if (memcmp(pRd, pText, 3) != 0) test_pass = false;
+        mosReleaseStreamBufferRead(&TestStream, 3);
+        // Reader is only woken at trigger level
+        mosInitAndRunThread(Threads[1], 1, StreamTestThreadRx, 0, Stacks[1], DFT_STACK_SIZE);
+        mosDelayThread(10);
+        mosWriteToStreamBuffer(&TestStream, pText, 3);
+        mosDelayThread(10);
+        if (TestHisto[0] != 0) test_pass = false;
+        mosWriteToStreamBuffer(&TestStream, pText, 3);
+        if (mosWaitForThreadStop(Threads[1]) != TEST_PASS) test_pass = false;
+        if (TestHisto[0] != 6) test_pass = false;
+    }
+    if (mosGetStreamBufferCount(&TestStream) != 0) test_pass = false;
+    if (test_pass) mosPrint(" Passed\n");
+    else {
+        mosPrint(" Failed\n");
+        tests_all_pass = false;
+    }
+    //
+    // Message buffer
+    //
+    test_pass = true;
+    mosPrint("Message Buffer Test\n");
+    mosInitMessageBuffer(&TestMsgBuf, StreamBuf, sizeof(StreamBuf));
+    {
+        const char * pText = "0123456789";
+        char rx[8];
+        u32 len;
+        if (mosGetMaxMessageSize(&TestMsgBuf) != 5) test_pass = false;
+        if (mosSendToMessageBuffer(&TestMsgBuf, pText, 6)) test_pass = false;
+        // Messages of different sizes, the third wraps to start of ring
+        if (!mosTrySendToMessageBuffer(&TestMsgBuf, pText, 5)) test_pass = false;
+        if (!mosSendToMessageBufferOrTO(&TestMsgBuf, pText, 3, 10)) test_pass = false;
+        if (mosTrySendToMessageBuffer(&TestMsgBuf, pText, 5)) test_pass = false;
+        if (mosGetNextMessageSize(&TestMsgBuf) != 5) test_pass = false;
+        if (mosTryReceiveFromMessageBuffer(&TestMsgBuf, rx, 4) != 0) test_pass = false;
+        if (mosReceiveFromMessageBuffer(&TestMsgBuf, rx, sizeof(rx)) != 5) test_pass = false;
+        if (memcmp(rx, pText, 5) != 0) test_pass = false;
+        u8 * pMsg = mosTryReserveMessage(&TestMsgBuf, 4);
+        if (pMsg == NULL) test_pass = false;
+        else {
+            memcpy(pMsg, pText + 4, 4);
+            mosCommitMessage(&TestMsgBuf);
+        }
+        if (mosReceiveFromMessageBufferOrTO(&TestMsgBuf, rx, sizeof(rx), 10) != 3) test_pass = false;
+        const u8 * pPeek = mosTryPeekMessage(&TestMsgBuf, &len);
+        if (pPeek != StreamBuf + 2 || len != 4 || memcmp(pPeek, pText + 4, 4) != 0) test_pass = false;
+        if (pPeek) mosReleaseMessage(&TestMsgBuf);
+        if (mosReceiveFromMessageBufferOrTO(&TestMsgBuf, rx, sizeof(rx), 10) != 0) test_pass = false;
+    }
+    if (test_pass) mosPrint(" Passed\n");
+    else {
+        mosPrint(" Failed\n");
+        tests_all_pass = false;
+    }
+    //
+    // Priority queue
+    //
+    test_pass = true;
+    mosPrint("Priority Queue Test\n");
+    {
+        static u32 priQueueBuf[MOS_PRI_QUEUE_BUF_SIZE(sizeof(u32), 4, 3) / sizeof(u32)];
+        MosPriQueue priQueue;
+        const u32 pri[4] = { 2, 0, 2, 1 };
+        const u32 exp[4] = { 1, 3, 0, 2 };
+        u32 val, valPri;
+        mosInitPriQueue(&priQueue, priQueueBuf, sizeof(u32), 4, 3);
+        for (u32 ix = 0; ix < 4; ix++) {
+            if (!mosTrySendToPriQueue(&priQueue, &ix, pri[ix])) test_pass = false;
+        }
+        if (mosTrySendToPriQueue(&priQueue, &val, 0)) test_pass = false;
+        if (mosSendToPriQueueOrTO(&priQueue, &val, 0, 10)) test_pass = false;
+        // Highest priority first, FIFO within a priority
+        for (u32 ix = 0; ix < 4; ix++) {
+            if (ix & 1) mosReceiveFromPriQueue(&priQueue, &val, &valPri);
+            else if (!mosTryReceiveFromPriQueue(&priQueue, &val, &valPri)) test_pass = false;
+            if (val != exp[ix] || valPri != pri[exp[ix]]) test_pass = false;
+        }
+        if (mosReceiveFromPriQueueOrTO(&priQueue, &val, NULL, 10)) test_pass = false;
+        mosSendToPriQueue(&priQueue, &exp[0], 1);
+        if (!mosReceiveFromPriQueueOrTO(&priQueue, &val, NULL, 10) || val != exp[0]) test_pass = false;
+    }
+    if (test_pass) mosPrint(" Passed\n");
+    else {
+        mosPrint(" Failed\n");
+        tests_all_pass = false;
+    }
     return tests_all_pass;
 }
 
@@ -1320,6 +2131,58 @@ static bool MultiTests(void) {
         mosPrint(" Failed\n");
         tests_all_pass = false;
     }
+    //
+    // Wait set of queue, semaphore, thread stop and timer
+    //
+    test_pass = true;
+    mosPrint("Wait Set Test\n");
+    {
+        MosWaitSet set;
+        MosWaitSetMember qMember, semMember, thdMember, tmrMember;
+        MosTimer tmr;
+        u32 val;
+        mosInitWaitSet(&set);
+        mosInitQueue32(&queue[0], queueBuf[0], count_of(queueBuf[0]));
+        mosInitSem(&TestSem, 0);
+        mosInitTimer(&tmr, ThreadTimerCallback);
+        mosAddQueueToWaitSet(&set, &qMember, &queue[0]);
+        mosAddSemToWaitSet(&set, &semMember, &TestSem);
+        mosAddTimerToWaitSet(&set, &tmrMember, &tmr);
+        if (mosPollWaitSet(&set) != NULL) test_pass = false;
+        // Queue member stays ready while messages remain
+        mosSendToQueue32(&queue[0], 1);
+        mosSendToQueue32(&queue[0], 2);
+        for (u32 ix = 1; ix <= 2; ix++) {
+            if (mosWaitOnWaitSet(&set) != &qMember) test_pass = false;
+            if (!mosTryReceiveFromQueue32(&queue[0], &val) || val != ix) test_pass = false;
+        }
+        mosIncrementSem(&TestSem);
+        if (mosWaitOnWaitSetOrTO(&set, 10) != &semMember) test_pass = false;
+        if (!mosTrySem(&TestSem)) test_pass = false;
+        if (mosWaitOnWaitSetOrTO(&set, 10) != NULL) test_pass = false;
+        // Thread stop and timer expiry
+        TestFlag = 0;
+        mosInitAndRunThread(Threads[1], 1, SemOrderTestThread, 0, Stacks[1], DFT_STACK_SIZE);
+        mosAddThreadToWaitSet(&set, &thdMember, Threads[1]);
+        mosSetTimer(&tmr, 20, NULL);
+        mosDelayThread(10);
+        if (mosPollWaitSet(&set) != NULL) test_pass = false;
+        mosRemoveFromWaitSet(&semMember);
+        mosIncrementSem(&TestSem);
+        if (mosWaitOnWaitSet(&set) != &thdMember) test_pass = false;
+        if (mosWaitOnWaitSetOrTO(&set, 50) != &tmrMember) test_pass = false;
+        if (mosPollWaitSet(&set) != NULL) test_pass = false;
+        mosRemoveFromWaitSet(&qMember);
+        mosRemoveFromWaitSet(&thdMember);
+        mosRemoveFromWaitSet(&tmrMember);
+        // Timer callback is restored on removal
+        if (tmr.pCallback != ThreadTimerCallback || tmr.pMember != NULL) test_pass = false;
+    }
+    if (test_pass) mosPrint(" Passed\n");
+    else {
+        mosPrint(" Failed\n");
+        tests_all_pass = false;
+    }
     return tests_all_pass;
 }
 
@@ -1402,18 +2265,41 @@ EXIT_MTT:
     return status;
 }
 
-#if 0
+// Builds a chain of blocked mutex owners:
+//   arg 0 holds TestMutex2 for a while, arg 1 holds TestMutex and waits for
+//   TestMutex2, and arg 2 waits for TestMutex.
 static s32 MutexNestedPrioInversionThread(s32 arg) {
-	for (;;) {
-		mosLockMutex(&TestMutex);
-		mosLockMutex(&TestMutex2);
-
+    switch (arg) {
+    case 0:
+        mosLockMutex(&TestMutex2);
+        mosDelayThread(10);
+        mosUnlockMutex(&TestMutex2);
+        break;
+    case 1:
+        mosLockMutex(&TestMutex);
+        mosLockMutex(&TestMutex2);
+        TestHisto[arg]++;
+        mosUnlockMutex(&TestMutex2);
+        mosUnlockMutex(&TestMutex);
+        break;
+    default:
+        mosLockMutex(&TestMutex);
+        TestHisto[arg]++;
+        mosUnlockMutex(&TestMutex);
+        break;
+    }
+    return TEST_PASS;
+}
 
-		mosUnlockMutex(&TestMutex2);
-		mosUnlockMutex(&TestMutex);
-	}
+// Mutex owner (arg 1) waits on TestSem before unlocking, while a higher
+//   priority thread (arg 3) waits for the mutex
+static s32 MutexInheritSemThread(s32 arg) {
+    mosLockMutex(&TestMutex);
+    if (arg == 1) mosWaitForSem(&TestSem);
+    TestHisto[TestFlag++] = arg;
+    mosUnlockMutex(&TestMutex);
+    return TEST_PASS;
 }
-#endif
 
 // Dummy thread is used for priority inheritance tests and
 //   runs at the middle priority.
@@ -1451,6 +2337,124 @@ static s32 MutexBusyThread(s32 arg) {
     return TEST_PASS;
 }
 
+static s32 CeilingMutexThreadHi(s32 arg) {
+    mosLockCeilingMutex(&TestCeilingMutex);
+    TestFlag = 1;
+    mosUnlockCeilingMutex(&TestCeilingMutex);
+    return TEST_PASS;
+}
+
+// Higher priority user of the ceiling mutex must not run until it is unlocked
+static s32 CeilingMutexThreadLo(s32 arg) {
+    TestFlag = 0;
+    mosLockCeilingMutex(&TestCeilingMutex);
+    mosLockCeilingMutex(&TestCeilingMutex);
+    mosInitAndRunThread(Threads[2], 2, CeilingMutexThreadHi, 0, Stacks[2], DFT_STACK_SIZE);
+    mosUnlockCeilingMutex(&TestCeilingMutex);
+    if (TestFlag != 0) return TEST_FAIL;
+    mosUnlockCeilingMutex(&TestCeilingMutex);
+    // Released thread preempts immediately on unlock
+    if (TestFlag != 1) return TEST_FAIL;
+    return TEST_PASS;
+}
+
+// Owner of the ceiling mutex is preempted by a thread above the ceiling that
+//   blocks (arg 0), or blocks while holding the mutex (arg 1). The other user
+//   of the mutex may not take it until it is unlocked.
+static s32 CeilingMutexPreemptThread(s32 arg) {
+    TestFlag = 0;
+    mosLockCeilingMutex(&TestCeilingMutex);
+    mosInitAndRunThread(Threads[2], 2, CeilingMutexThreadHi, 0, Stacks[2], DFT_STACK_SIZE);
+    if (arg == 0) {
+        mosInitAndRunThread(Threads[3], 1, ThresholdBlockTestThread, 0, Stacks[3], DFT_STACK_SIZE);
+        u32 tick = mosGetTickCount();
+        while ((s32)(mosGetTickCount() - tick) < 3);
+    } else mosDelayThread(2);
+    if (TestFlag != 0) return TEST_FAIL;
+    mosUnlockCeilingMutex(&TestCeilingMutex);
+    if (TestFlag != 1) return TEST_FAIL;
+    return TEST_PASS;
+}
+
+// arg 1 writes, others read (arg 2 must read after the write)
+static s32 RwLockTestThread(s32 arg) {
+    s32 status = TEST_PASS;
+    if (arg == 1) {
+        mosWriteLock(&TestRwLock);
+        TestFlag = 1;
+        TestHisto[arg]++;
+        mosWriteUnlock(&TestRwLock);
+    } else {
+        mosReadLock(&TestRwLock);
+        if (arg == 2 && TestFlag != 1) status = TEST_FAIL;
+        TestHisto[arg]++;
+        mosReadUnlock(&TestRwLock);
+    }
+    return status;
+}
+
+// arg 0 holds write lock across unrelated mutex, arg 1 waits on mutex,
+//   arg 2 reads, arg 3 holds read lock, arg 4 waits on write lock with mutex
+//   held, arg 5 holds read lock until killed
+static s32 RwLockInheritThread(s32 arg) {
+    s32 status = TEST_PASS;
+    MosThread * pThd = mosGetRunningThread();
+    switch (arg) {
+    case 0:
+        mosWriteLock(&TestRwLock);
+        mosLockMutex(&TestMutex);
+        mosDelayThread(2);
+        mosUnlockMutex(&TestMutex);
+        // Boost from reader waiting on the lock remains in effect
+        if (mosGetThreadPriority(pThd) != 1) status = TEST_FAIL;
+        mosWriteUnlock(&TestRwLock);
+        if (mosGetThreadPriority(pThd) != 4) status = TEST_FAIL;
+        break;
+    case 1:
+        mosLockMutex(&TestMutex);
+        mosUnlockMutex(&TestMutex);
+        break;
+    case 2:
+        mosReadLock(&TestRwLock);
+        mosReadUnlock(&TestRwLock);
+        break;
+    case 3:
+        mosReadLock(&TestRwLock);
+        mosDelayThread(5);
+        if (mosGetThreadPriority(pThd) != 1) status = TEST_FAIL;
+        mosReadUnlock(&TestRwLock);
+        if (mosGetThreadPriority(pThd) != 4) status = TEST_FAIL;
+        break;
+    case 4:
+        mosLockMutex(&TestMutex);
+        mosWriteLock(&TestRwLock);
+        mosWriteUnlock(&TestRwLock);
+        mosUnlockMutex(&TestMutex);
+        break;
+    case 5:
+        mosReadLock(&TestRwLock);
+        mosDelayThread(1000);
+        mosReadUnlock(&TestRwLock);
+        break;
+    }
+    TestHisto[arg]++;
+    return status;
+}
+
+// Waits with the mutex held recursively until TestFlag reaches arg
+static s32 CondVarTestThread(s32 arg) {
+    s32 status = TEST_PASS;
+    mosLockMutex(&TestMutex);
+    mosLockMutex(&TestMutex);
+    while (TestFlag < (u32)arg) mosWaitForCondVar(&TestCondVar);
+    TestHisto[arg]++;
+    mosUnlockMutex(&TestMutex);
+    // Recursion depth is preserved across waits
+    if (!mosIsMutexOwner(&TestMutex)) status = TEST_FAIL;
+    mosUnlockMutex(&TestMutex);
+    return status;
+}
+
 static bool MutexTests(void) {
     bool tests_all_pass = true;
     bool test_pass;
@@ -1571,7 +2575,6 @@ static bool MutexTests(void) {
         mosPrint(" Failed\n");
         tests_all_pass = false;
     }
-#if 0
     //
     // Priority Inheritance (nested)
     //
@@ -1579,13 +2582,63 @@ static bool MutexTests(void) {
     mosPrint("Mutex Nested Priority Inversion\n");
     ClearHistogram();
     mosInitMutex(&TestMutex);
-
+    mosInitMutex(&TestMutex2);
+    mosInitAndRunThread(Threads[1], 4, MutexNestedPrioInversionThread, 0,
+                        Stacks[1], DFT_STACK_SIZE);
+    mosDelayThread(1);
+    mosInitAndRunThread(Threads[2], 3, MutexNestedPrioInversionThread, 1,
+                        Stacks[2], DFT_STACK_SIZE);
+    mosDelayThread(1);
+    mosInitAndRunThread(Threads[3], 1, MutexNestedPrioInversionThread, 2,
+                        Stacks[3], DFT_STACK_SIZE);
+    mosDelayThread(1);
+    // Boost should propagate through both owners
+    if (mosGetThreadPriority(Threads[2]) != 1) test_pass = false;
+    if (mosGetThreadPriority(Threads[1]) != 1) test_pass = false;
+    if (mosWaitForThreadStop(Threads[1]) != TEST_PASS) test_pass = false;
+    if (mosWaitForThreadStop(Threads[2]) != TEST_PASS) test_pass = false;
+    if (mosWaitForThreadStop(Threads[3]) != TEST_PASS) test_pass = false;
+    if (TestHisto[1] != 1 || TestHisto[2] != 1) test_pass = false;
+    // Make sure thread priorities are restored
+    if (mosGetThreadPriority(Threads[1]) != 4) test_pass = false;
+    if (mosGetThreadPriority(Threads[2]) != 3) test_pass = false;
+    if (mosGetThreadPriority(Threads[3]) != 1) test_pass = false;
+    if (test_pass) mosPrint(" Passed\n");
+    else {
+        mosPrint(" Failed\n");
+        tests_all_pass = false;
+    }
+    //
+    // Priority Inheritance (owner waiting on semaphore)
+    //
+    test_pass = true;
+    mosPrint("Mutex Inheritance Sem Waiter\n");
+    ClearHistogram();
+    TestFlag = 0;
+    mosInitMutex(&TestMutex);
+    mosInitSem(&TestSem, 0);
+    mosInitAndRunThread(Threads[1], 4, MutexInheritSemThread, 1, Stacks[1], DFT_STACK_SIZE);
+    mosDelayThread(1);
+    mosInitAndRunThread(Threads[2], 3, SemOrderTestThread, 2, Stacks[2], DFT_STACK_SIZE);
+    mosDelayThread(1);
+    mosInitAndRunThread(Threads[3], 1, MutexInheritSemThread, 3, Stacks[3], DFT_STACK_SIZE);
+    mosDelayThread(1);
+    if (mosGetThreadPriority(Threads[1]) != 1) test_pass = false;
+    // Boosted owner was moved ahead of the other semaphore waiter
+    mosIncrementSem(&TestSem);
+    mosDelayThread(1);
+    mosIncrementSem(&TestSem);
+    if (mosWaitForThreadStop(Threads[1]) != TEST_PASS) test_pass = false;
+    if (mosWaitForThreadStop(Threads[2]) != TEST_PASS) test_pass = false;
+    if (mosWaitForThreadStop(Threads[3]) != TEST_PASS) test_pass = false;
+    DisplayHistogram(3);
+    if (TestHisto[0] != 1 || TestHisto[1] != 3 || TestHisto[2] != 2) test_pass = false;
+    if (mosGetThreadPriority(Threads[1]) != 4) test_pass = false;
     if (test_pass) mosPrint(" Passed\n");
     else {
         mosPrint(" Failed\n");
         tests_all_pass = false;
     }
-#endif
     //
     // Mutex Priority Change Test
     //
@@ -1622,6 +2675,137 @@ static bool MutexTests(void) {
         mosPrint(" Failed\n");
         tests_all_pass = false;
     }
+    //
+    // Ceiling Mutex Test
+    //
+    test_pass = true;
+    mosPrint("Ceiling Mutex\n");
+    mosInitCeilingMutex(&TestCeilingMutex, 2);
+    mosInitAndRunThread(Threads[1], 3, CeilingMutexThreadLo, 0, Stacks[1], DFT_STACK_SIZE);
+    if (mosWaitForThreadStop(Threads[1]) != TEST_PASS) test_pass = false;
+    if (mosWaitForThreadStop(Threads[2]) != TEST_PASS) test_pass = false;
+    mosInitAndRunThread(Threads[1], 3, CeilingMutexPreemptThread, 0, Stacks[1], DFT_STACK_SIZE);
+    if (mosWaitForThreadStop(Threads[1]) != TEST_PASS) test_pass = false;
+    if (mosWaitForThreadStop(Threads[2]) != TEST_PASS) test_pass = false;
+    if (mosWaitForThreadStop(Threads[3]) != TEST_PASS) test_pass = false;
+    mosInitAndRunThread(Threads[1], 3, CeilingMutexPreemptThread, 1, Stacks[1], DFT_STACK_SIZE);
+    if (mosWaitForThreadStop(Threads[1]) != TEST_PASS) test_pass = false;
+    if (mosWaitForThreadStop(Threads[2]) != TEST_PASS) test_pass = false;
+    if (test_pass) mosPrint(" Passed\n");
+    else {
+        mosPrint(" Failed\n");
+        tests_all_pass = false;
+    }
+    //
+    // Reader-Writer Lock Test
+    //
+    test_pass = true;
+    mosPrint("Reader-Writer Lock\n");
+    ClearHistogram();
+    TestFlag = 0;
+    mosInitRwLock(&TestRwLock);
+    mosReadLock(&TestRwLock);
+    // Readers share the lock
+    mosInitAndRunThread(Threads[1], 2, RwLockTestThread, 0, Stacks[1], DFT_STACK_SIZE);
+    mosDelayThread(2);
+    if (TestHisto[0] != 1) test_pass = false;
+    // Writer waits for readers, later readers wait for writer
+    mosInitAndRunThread(Threads[2], 1, RwLockTestThread, 1, Stacks[2], DFT_STACK_SIZE);
+    mosDelayThread(2);
+    mosInitAndRunThread(Threads[3], 2, RwLockTestThread, 2, Stacks[3], DFT_STACK_SIZE);
+    mosDelayThread(2);
+    if (TestHisto[1] != 0 || TestHisto[2] != 0) test_pass = false;
+    if (mosReadLockOrTO(&TestRwLock, 2)) test_pass = false;
+    mosReadUnlock(&TestRwLock);
+    if (mosWaitForThreadStop(Threads[1]) != TEST_PASS) test_pass = false;
+    if (mosWaitForThreadStop(Threads[2]) != TEST_PASS) test_pass = false;
+    if (mosWaitForThreadStop(Threads[3]) != TEST_PASS) test_pass = false;
+    if (TestHisto[1] != 1 || TestHisto[2] != 1) test_pass = false;
+    if (test_pass) mosPrint(" Passed\n");
+    else {
+        mosPrint(" Failed\n");
+        tests_all_pass = false;
+    }
+    //
+    // Reader-Writer Lock Inheritance Test
+    //
+    test_pass = true;
+    mosPrint("Reader-Writer Lock Inheritance\n");
+    ClearHistogram();
+    mosInitRwLock(&TestRwLock);
+    mosInitMutex(&TestMutex);
+    // Writer keeps boost after unlocking an unrelated mutex
+    mosInitAndRunThread(Threads[1], 4, RwLockInheritThread, 0, Stacks[1], DFT_STACK_SIZE);
+    mosDelayThread(1);
+    mosInitAndRunThread(Threads[2], 2, RwLockInheritThread, 1, Stacks[2], DFT_STACK_SIZE);
+    mosInitAndRunThread(Threads[3], 1, RwLockInheritThread, 2, Stacks[3], DFT_STACK_SIZE);
+    if (mosWaitForThreadStop(Threads[1]) != TEST_PASS) test_pass = false;
+    if (mosWaitForThreadStop(Threads[2]) != TEST_PASS) test_pass = false;
+    if (mosWaitForThreadStop(Threads[3]) != TEST_PASS) test_pass = false;
+    // Boost passes through mutex owner blocked on the lock to the reader
+    mosInitAndRunThread(Threads[1], 4, RwLockInheritThread, 3, Stacks[1], DFT_STACK_SIZE);
+    mosDelayThread(1);
+    mosInitAndRunThread(Threads[2], 3, RwLockInheritThread, 4, Stacks[2], DFT_STACK_SIZE);
+    mosDelayThread(1);
+    mosInitAndRunThread(Threads[3], 1, RwLockInheritThread, 1, Stacks[3], DFT_STACK_SIZE);
+    mosDelayThread(1);
+    if (mosGetThreadPriority(Threads[2]) != 1) test_pass = false;
+    if (mosGetThreadPriority(Threads[1]) != 1) test_pass = false;
+    if (mosWaitForThreadStop(Threads[1]) != TEST_PASS) test_pass = false;
+    if (mosWaitForThreadStop(Threads[2]) != TEST_PASS) test_pass = false;
+    if (mosWaitForThreadStop(Threads[3]) != TEST_PASS) test_pass = false;
+    if (mosGetThreadPriority(Threads[2]) != 3) test_pass = false;
+    // Killed reader releases the lock
+    mosInitAndRunThread(Threads[1], 2, RwLockInheritThread, 5, Stacks[1], DFT_STACK_SIZE);
+    mosDelayThread(1);
+    mosKillThread(Threads[1]);
+    mosWaitForThreadStop(Threads[1]);
+    if (mosWriteLockOrTO(&TestRwLock, 2)) mosWriteUnlock(&TestRwLock);
+    else test_pass = false;
+    if (TestHisto[0] != 1 || TestHisto[1] != 2 || TestHisto[2] != 1 ||
+        TestHisto[3] != 1 || TestHisto[4] != 1 || TestHisto[5] != 0) test_pass = false;
+    if (test_pass) mosPrint(" Passed\n");
+    else {
+        mosPrint(" Failed\n");
+        tests_all_pass = false;
+    }
+    //
+    // Condition Variable Test
+    //
+    test_pass = true;
+    mosPrint("Condition Variable\n");
+    ClearHistogram();
+    TestFlag = 0;
+    mosInitMutex(&TestMutex);
+    mosInitCondVar(&TestCondVar, &TestMutex);
+    mosInitAndRunThread(Threads[1], 1, CondVarTestThread, 1, Stacks[1], DFT_STACK_SIZE);
+    mosInitAndRunThread(Threads[2], 2, CondVarTestThread, 1, Stacks[2], DFT_STACK_SIZE);
+    mosInitAndRunThread(Threads[3], 3, CondVarTestThread, 2, Stacks[3], DFT_STACK_SIZE);
+    mosDelayThread(2);
+    mosLockMutex(&TestMutex);
+    if (mosWaitForCondVarOrTO(&TestCondVar, 2)) test_pass = false;
+    if (!mosIsMutexOwner(&TestMutex)) test_pass = false;
+    // Broadcast while holding mutex, waiters run once it is released
+    TestFlag = 1;
+    mosBroadcastCondVar(&TestCondVar);
+    mosDelayThread(2);
+    if (TestHisto[1] != 0) test_pass = false;
+    mosUnlockMutex(&TestMutex);
+    mosDelayThread(2);
+    if (TestHisto[1] != 2 || TestHisto[2] != 0) test_pass = false;
+    mosLockMutex(&TestMutex);
+    TestFlag = 2;
+    mosSignalCondVar(&TestCondVar);
+    mosUnlockMutex(&TestMutex);
+    if (mosWaitForThreadStop(Threads[1]) != TEST_PASS) test_pass = false;
+    if (mosWaitForThreadStop(Threads[2]) != TEST_PASS) test_pass = false;
+    if (mosWaitForThreadStop(Threads[3]) != TEST_PASS) test_pass = false;
+    if (TestHisto[2] != 1) test_pass = false;
+    if (test_pass) mosPrint(" Passed\n");
+    else {
+        mosPrint(" Failed\n");
+        tests_all_pass = false;
+    }
     return tests_all_pass;
 }
 
@@ -1891,6 +3075,21 @@ static bool SecurityTests(void) {
 
 #endif
 
+#define ATOMIC_TEST_ITER   20000
+
+static s32 AtomicCount;
+
+// Contends with another thread (time sliced) and with IRQ 0 giving TestSem
+static s32 AtomicTestThread(s32 arg) {
+    MOS_UNUSED(arg);
+    for (u32 ix = 0; ix < ATOMIC_TEST_ITER; ix++) {
+        mosAtomicFetchAndAdd32(&AtomicCount, 1);
+        mosIncrementSem(&TestSem);
+    }
+    mosAtomicFetchAndAdd32((s32 *)&TestFlag, 1);
+    return TEST_PASS;
+}
+
 static s32 StackPrintThread(s32 arg) {
     MOS_UNUSED(arg);
     u64 e = 0xdeadbeeffeebdaed;
@@ -1940,6 +3139,37 @@ static bool MiscTests(void) {
         mosPrint(" Failed\n");
         tests_all_pass = false;
     }
+    //
+    // Atomics and semaphores preempted by threads and ISRs lose no updates
+    //
+    test_pass = true;
+    mosPrint("Misc Test: Atomic contention\n");
+    ClearHistogram();
+    TestFlag = 0;
+    AtomicCount = 0;
+    mosInitSem(&TestSem, 0);
+    mosSetTimeSlice(1, 1);
+    mosInitAndRunThread(Threads[1], 1, AtomicTestThread, 0, Stacks[1], DFT_STACK_SIZE);
+    mosInitAndRunThread(Threads[2], 1, AtomicTestThread, 1, Stacks[2], DFT_STACK_SIZE);
+    while (TestFlag < 2) {
+        HalTestsTriggerInterrupt(0);
+        mosDelayThread(1);
+    }
+    if (mosWaitForThreadStop(Threads[1]) != TEST_PASS) test_pass = false;
+    if (mosWaitForThreadStop(Threads[2]) != TEST_PASS) test_pass = false;
+    mosSetTimeSlice(1, MOS_DEFAULT_TIME_SLICE);
+    {
+        u32 given = 0;
+        while (mosTrySem(&TestSem)) given++;
+        mosPrintf(" Count = %u, Sem = %u, IRQs = %u\n", AtomicCount, given, TestHisto[0]);
+        if (AtomicCount != 2 * ATOMIC_TEST_ITER) test_pass = false;
+        if (given != 2 * ATOMIC_TEST_ITER + TestHisto[0]) test_pass = false;
+    }
+    if (test_pass) mosPrint(" Passed\n");
+    else {
+        mosPrint(" Failed\n");
+        tests_all_pass = false;
+    }
 #if (MOS_ENABLE_SPLIM_SUPPORT == true)
     //
     // PSPLIM tests
@@ -2097,6 +3327,214 @@ static bool MiscTests(void) {
     return tests_all_pass;
 }
 
+//
+// Benchmarks
+//
+
+#define SCHED_BENCH_ITER   1000
+
+// Measures average cycles per yield, each yield is a full pass through PendSV
+//   and the scheduler that reschedules the same thread.
+static s32 SchedBenchThread(s32 arg) {
+    MOS_UNUSED(arg);
+    u64 start = mosGetCycleCount();
+    for (u32 ix = 0; ix < SCHED_BENCH_ITER; ix++) mosYieldThread();
+    return (s32)((mosGetCycleCount() - start) / SCHED_BENCH_ITER);
+}
+
+#define WAKE_BENCH_ITER    1000
+
+static volatile u64 WakeStamp;
+
+// Measures average cycles from post to wake-up of a higher priority thread,
+//   using a semaphore (arg == 0) or a thread notification (arg == 1).
+static s32 WakeBenchRx(s32 arg) {
+    u32 total = 0;
+    for (u32 ix = 0; ix < WAKE_BENCH_ITER; ix++) {
+        if (arg) mosWaitForNotify(0xffffffff);
+        else mosWaitForSem(&TestSem);
+        total += (u32)(mosGetCycleCount() - WakeStamp);
+    }
+    return (s32)(total / WAKE_BENCH_ITER);
+}
+
+static s32 WakeBenchTx(s32 arg) {
+    for (u32 ix = 0; ix < WAKE_BENCH_ITER; ix++) {
+        WakeStamp = mosGetCycleCount();
+        if (arg) mosNotifyThread(Threads[1], 1, MOS_NOTIFY_SET_BITS);
+        else mosIncrementSem(&TestSem);
+    }
+    return TEST_PASS;
+}
+
+#if (MOS_ENABLE_DEFERRED_TIMERS == true)
+
+#define TIMER_BENCH_COUNT  8
+
+static MosTimer BenchTimers[TIMER_BENCH_COUNT];
+
+static bool SlowTimerCallback(MosTimer * pTmr) {
+    MOS_UNUSED(pTmr);
+    mosDelayMicroseconds(20);
+    TestHisto[0]++;
+    return true;
+}
+
+// Expire all bench timers on the same tick, returning worst case tick ISR cycles
+static u32 TimerBench(void) {
+    ClearHistogram();
+    mosDelayThread(1);
+    mosResetMaxTickCycles();
+    for (u32 ix = 0; ix < TIMER_BENCH_COUNT; ix++)
+        mosSetTimer(&BenchTimers[ix], 5, NULL);
+    mosDelayThread(10);
+    return mosGetMaxTickCycles();
+}
+
+#endif
+
+// Busy-waits without blocking, ticks should not invoke the scheduler
+//   while no other thread of the same priority is runnable.
+static s32 AvoidedSwitchThread(s32 arg) {
+    u32 start = mosGetAvoidedContextSwitchCount();
+    u32 tick = mosGetTickCount();
+    while ((s32)(mosGetTickCount() - tick) < arg);
+    return (s32)(mosGetAvoidedContextSwitchCount() - start);
+}
+
+#define PROBE_LOOP_COUNT   1000
+
+// Spins until probe IRQ fires, returning number of iterations elapsed
+static u32 SpinForProbe(void) {
+    u32 ix;
+    for (ix = 0; ix < PROBE_LOOP_COUNT; ix++) {
+        if (ProbeFired) break;
+    }
+    return ix;
+}
+
+// Pends the high priority probe IRQ within a kernel critical section,
+//   returning spin iterations elapsed before it ran.
+static u32 ProbeIRQLatency(void) {
+    ProbeFired = false;
+    u32 mask = mosDisableInterrupts();
+    HalTestsTriggerInterrupt(2);
+    u32 iter = SpinForProbe();
+    mosEnableInterrupts(mask);
+    return iter;
+}
+
+static bool BenchTests(void) {
+    bool tests_all_pass = true;
+    bool test_pass;
+    //
+    // Scheduler cost versus number of priorities
+    //   Report only: rebuild with MOS_MAX_THREAD_PRIORITIES of e.g. 8, 32 and
+    //   64 and compare, figures should not grow with the priority count.
+    //   Cycle counts vary with caches and flash wait states, so no pass/fail.
+    //
+    mosPrint("Bench: Scheduler cycles versus priorities\n");
+    {
+        MosThreadPriority pris[2] = { 0, MOS_MAX_THREAD_PRIORITIES - 1 };
+        u32 cycles[2];
+        for (u32 ix = 0; ix < 2; ix++) {
+            mosInitAndRunThread(Threads[1], pris[ix], SchedBenchThread, 0, Stacks[1], DFT_STACK_SIZE);
+            cycles[ix] = (u32)mosWaitForThreadStop(Threads[1]);
+        }
+        mosPrintf(" Priorities = %u, Hi = %u cycles, Lo = %u cycles\n",
+                  MOS_MAX_THREAD_PRIORITIES, cycles[0], cycles[1]);
+    }
+    //
+    // Notifications must wake threads at least as fast as semaphores
+    //
+    test_pass = true;
+    mosPrint("Bench: Wake latency, semaphore versus notification\n");
+    {
+        u32 cycles[2];
+        for (u32 ix = 0; ix < 2; ix++) {
+            mosInitSem(&TestSem, 0);
+            mosInitAndRunThread(Threads[1], 1, WakeBenchRx, ix, Stacks[1], DFT_STACK_SIZE);
+            mosInitAndRunThread(Threads[2], 2, WakeBenchTx, ix, Stacks[2], DFT_STACK_SIZE);
+            cycles[ix] = (u32)mosWaitForThreadStop(Threads[1]);
+            if (mosWaitForThreadStop(Threads[2]) != TEST_PASS) test_pass = false;
+        }
+        mosPrintf(" Sem = %u cycles, Notify = %u cycles\n", cycles[0], cycles[1]);
+        if (cycles[1] > cycles[0]) test_pass = false;
+    }
+    if (test_pass) mosPrint(" Passed\n");
+    else {
+        mosPrint(" Failed\n");
+        tests_all_pass = false;
+    }
+#if (MOS_ENABLE_DEFERRED_TIMERS == true)
+    //
+    // Deferred timers keep tick ISR short
+    //
+    test_pass = true;
+    mosPrint("Bench: Worst case tick ISR, ISR versus deferred timers\n");
+    {
+        u32 cycles[2];
+        for (u32 ix = 0; ix < TIMER_BENCH_COUNT; ix++)
+            mosInitTimer(&BenchTimers[ix], SlowTimerCallback);
+        cycles[0] = TimerBench();
+        if (TestHisto[0] != TIMER_BENCH_COUNT) test_pass = false;
+        for (u32 ix = 0; ix < TIMER_BENCH_COUNT; ix++)
+            mosInitDeferredTimer(&BenchTimers[ix], SlowTimerCallback);
+        cycles[1] = TimerBench();
+        if (TestHisto[0] != TIMER_BENCH_COUNT) test_pass = false;
+        mosPrintf(" ISR = %u cycles, Deferred = %u cycles\n", cycles[0], cycles[1]);
+        if (cycles[1] >= cycles[0]) test_pass = false;
+    }
+    if (test_pass) mosPrint(" Passed\n");
+    else {
+        mosPrint(" Failed\n");
+        tests_all_pass = false;
+    }
+#endif
+    //
+    // Ticks skip the scheduler when there is nothing to schedule
+    //
+    test_pass = true;
+    mosPrint("Bench: Context switches avoided by tick\n");
+    {
+        mosInitAndRunThread(Threads[1], 1, AvoidedSwitchThread, 20, Stacks[1], DFT_STACK_SIZE);
+        u32 avoided = (u32)mosWaitForThreadStop(Threads[1]);
+        mosPrintf(" Avoided = %u of 20 ticks\n", avoided);
+        if (avoided < 18) test_pass = false;
+    }
+    if (test_pass) mosPrint(" Passed\n");
+    else {
+        mosPrint(" Failed\n");
+        tests_all_pass = false;
+    }
+    //
+    // IRQs above max syscall priority are not delayed by kernel critical sections
+    //
+    test_pass = true;
+    mosPrint("Bench: Probe IRQ latency within kernel critical section\n");
+    {
+        u32 iter = ProbeIRQLatency();
+        mosDelayThread(1);
+        if (ProbeFired) {
+            // Time a full spin to convert iterations to cycles
+            ProbeFired = false;
+            u64 start = mosGetCycleCount();
+            SpinForProbe();
+            u32 cycles = (u32)(mosGetCycleCount() - start) * iter / PROBE_LOOP_COUNT;
+            mosPrintf(" Latency = %u cycles\n", cycles);
+            if (MOS_BASEPRI_CRITICAL_SECTIONS) {
+                if (iter == PROBE_LOOP_COUNT) test_pass = false;
+            } else if (iter != PROBE_LOOP_COUNT) test_pass = false;
+        } else mosPrint(" No probe IRQ on this target\n");
+    }
+    if (test_pass) mosPrint(" Passed\n");
+    else {
+        mosPrint(" Failed\n");
+        tests_all_pass = false;
+    }
+    return tests_all_pass;
+}
+
 static s32 CmdTest(s32 argc, char * argv[]) {
     bool test_pass = true;
     if (argc >= 2 && strcmp(argv[1], "hal") == 0) {
@@ -2132,6 +3570,8 @@ static s32 CmdTest(s32 argc, char * argv[]) {
 #endif
         } else if (strcmp(argv[1], "misc") == 0) {
             test_pass = MiscTests();
+        } else if (strcmp(argv[1], "bench") == 0) {
+            test_pass = BenchTests();
         } else return CMD_ERR_NOT_FOUND;
         if (test_pass) {
             mosPrint("Tests Passed\n");
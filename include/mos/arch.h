@@ -74,6 +74,70 @@
 // Interrupt methods
 //
 
+// Kernel critical sections use BASEPRI to leave interrupts of priority higher
+//   than MOS_MAX_SYSCALL_INT_PRIORITY unmasked (mainline only).
+#if (MOS_ARCH_CAT == MOS_ARCH_ARM_CORTEX_M_MAIN) && (MOS_MAX_SYSCALL_INT_PRIORITY != 0)
+  #define MOS_BASEPRI_CRITICAL_SECTIONS  true
+#else
+  #define MOS_BASEPRI_CRITICAL_SECTIONS  false
+#endif
+
+#if (MOS_BASEPRI_CRITICAL_SECTIONS == true)
+
+/// Disable Interrupts (Not nestable, assumes interrupts are enabled prior to call).
+///   Only interrupts at or below MOS_MAX_SYSCALL_INT_PRIORITY are masked.
+MOS_ISR_SAFE static MOS_INLINE void _mosDisableInterrupts(void) {
+    asm volatile (
+        "msr basepri_max, %0\n"
+        "isb"
+            : : "r" (MOS_MAX_SYSCALL_INT_PRIORITY) : "memory"
+    );
+}
+
+/// Enable Interrupts (Not nestable, assumes interrupts are disabled prior to call).
+///
+MOS_ISR_SAFE static MOS_INLINE void _mosEnableInterrupts(void) {
+    asm volatile (
+        "msr basepri, %0"
+            : : "r" (0) : "memory"
+    );
+}
+
+/// Enable Interrupts (Not nestable, assumes interrupts are disabled prior to call).
+/// Provides barrier to ensure pending interrupt executes before
+///   subsequent instructions.  Can be combined with _MosEnableInterrupts().
+MOS_ISR_SAFE static MOS_INLINE void _mosEnableInterruptsWithBarrier(void) {
+    asm volatile (
+        "msr basepri, %0\n"
+        "isb"
+            : : "r" (0) : "memory"
+    );
+}
+
+/// Disable interrupts (Nestable, recommended for ISRs).
+///   Saves mask to remember if interrupts were already disabled prior to this.
+MOS_ISR_SAFE static MOS_INLINE u32 mosDisableInterrupts(void) {
+    u32 mask;
+    asm volatile (
+        "mrs %0, basepri\n"
+        "msr basepri_max, %1\n"
+        "isb"
+            : "=&r" (mask) : "r" (MOS_MAX_SYSCALL_INT_PRIORITY) : "memory"
+    );
+    return mask;
+}
+
+/// Enable Interrupts (Nestable, recommended for ISRs).
+///   Only enables if mask indicates interrupts had been enabled in prior call to MosDisableInterrupts().
+MOS_ISR_SAFE static MOS_INLINE void mosEnableInterrupts(u32 mask) {
+    asm volatile (
+        "msr basepri, %0"
+            : : "r" (mask) : "memory"
+    );
+}
+
+#else
+
 /// Disable Interrupts (Not nestable, assumes interrupts are enabled prior to call).
 ///
 MOS_ISR_SAFE static MOS_INLINE void _mosDisableInterrupts(void) {
@@ -115,6 +179,8 @@ MOS_ISR_SAFE static MOS_INLINE void mosEnableInterrupts(u32 mask) {
     );
 }
 
+#endif
+
 /// Used to determine if in interrupt context.
 /// \return '0' if not in an interrupt, otherwise returns vector number
 MOS_ISR_SAFE static MOS_INLINE u32 mosGetIRQNumber(void) {
@@ -133,28 +199,16 @@ MOS_ISR_SAFE static MOS_INLINE u32 mosGetIRQNumber(void) {
 #if (MOS_ARCH_CAT == MOS_ARCH_ARM_CORTEX_M_BASE)
 
 // GCC does not implement atomic builtins for Base.
+//   Threads use restartable sequences (interrupts remain enabled),
+//   ISRs disable interrupts (see kernel_base.inc).
 
 /// Atomic fetch and add
 ///
-MOS_ISR_SAFE static MOS_INLINE s32
-mosAtomicFetchAndAdd32(s32 * pValue, s32 addVal) {
-    u32 mask = mosDisableInterrupts();
-    s32 val = *pValue;
-    *pValue = val + addVal;
-    mosEnableInterrupts(mask);
-    return val;
-}
+MOS_ISR_SAFE s32 mosAtomicFetchAndAdd32(s32 * pValue, s32 addVal);
 
 /// Atomic compare and swap
 ///
-MOS_ISR_SAFE static MOS_INLINE u32
-mosAtomicCompareAndSwap32(u32 * pValue, u32 compareVal, u32 exchangeVal) {
-    u32 mask = mosDisableInterrupts();
-    u32 val = *pValue;
-    if (*pValue == compareVal) *pValue = exchangeVal;
-    mosEnableInterrupts(mask);
-    return val;
-}
+MOS_ISR_SAFE u32 mosAtomicCompareAndSwap32(u32 * pValue, u32 compareVal, u32 exchangeVal);
 
 #elif (MOS_ARCH_CAT == MOS_ARCH_ARM_CORTEX_M_MAIN)
 
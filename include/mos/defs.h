@@ -21,6 +21,7 @@
 #ifndef MOS_MAX_THREAD_PRIORITIES
 /// Thread priorities <=> [0 ... MOS_MAX_THREAD_PRIORITIES - 1].
 /// The lower the number the higher the priority
+/// Up to 255 priorities are supported, scheduling time does not depend on this value.
 #define MOS_MAX_THREAD_PRIORITIES       8
 #endif
 
@@ -30,6 +31,94 @@
 #define MOS_TICKS_PER_SECOND            1000
 #endif
 
+#ifndef MOS_DEFAULT_TIME_SLICE
+/// Default round-robin time slice in ticks for all priorities.
+/// Zero disables time-slicing (threads of same priority run FIFO).
+#define MOS_DEFAULT_TIME_SLICE          1
+#endif
+
+#ifndef MOS_ENABLE_EDF
+/// Enable earliest-deadline-first (EDF) scheduling band.
+/// Threads at priority MOS_EDF_PRIORITY are scheduled by earliest deadline.
+#define MOS_ENABLE_EDF                  false
+#endif
+
+#ifndef MOS_EDF_PRIORITY
+/// Priority level occupied by the EDF band (if enabled).
+///
+#define MOS_EDF_PRIORITY                1
+#endif
+
+#ifndef MOS_EDF_MAX_THREADS
+/// Maximum number of simultaneously runnable threads in the EDF band.
+///
+#define MOS_EDF_MAX_THREADS             8
+#endif
+
+#ifndef MOS_MAX_INHERIT_DEPTH
+/// Maximum length of mutex owner chain followed by priority inheritance.
+#define MOS_MAX_INHERIT_DEPTH           4
+#endif
+
+#ifndef MOS_PEND_QUEUE_BUCKETS
+/// Track priority buckets in pend queues so blocking is constant time with
+/// many waiters. Adds (MOS_MAX_THREAD_PRIORITIES + 1) words to each mutex,
+/// semaphore, event group, condition variable and reader-writer lock.
+#define MOS_PEND_QUEUE_BUCKETS          false
+#endif
+
+#ifndef MOS_RWLOCK_READER_SLOTS
+/// Number of readers per reader-writer lock tracked for priority inheritance.
+#define MOS_RWLOCK_READER_SLOTS         4
+#endif
+
+#ifndef MOS_QUEUE_COPY_CHUNK_WORDS
+/// Words of queue message data copied per critical section by copying sends
+/// and receives, bounding interrupt latency of batched calls (at least one
+/// element is copied at a time).
+#define MOS_QUEUE_COPY_CHUNK_WORDS      32
+#endif
+
+#ifndef MOS_MAX_SYSCALL_INT_PRIORITY
+/// Highest interrupt priority (in BASEPRI format, priority bits in the MSBs) that
+/// may call MOS APIs. On v7-M/v8-M mainline a nonzero value makes kernel critical
+/// sections mask only interrupts at or below this priority via BASEPRI, so higher
+/// priority interrupts are never delayed by the kernel, but must not call MOS APIs.
+/// Zero masks all interrupts via PRIMASK (as always on v6-M/v8-M baseline).
+#define MOS_MAX_SYSCALL_INT_PRIORITY    0
+#endif
+
+#ifndef MOS_ENABLE_CPU_BUDGETS
+/// Enable per-thread CPU budgets (see mosSetThreadBudget()).
+/// Adds cycle counter accounting to every context switch and tick.
+#define MOS_ENABLE_CPU_BUDGETS          false
+#endif
+
+#ifndef MOS_TIMER_WHEEL_LEVELS
+/// Number of timing wheel levels (1 to 6), each of 32 slots. Timeouts up to
+/// 32^levels ticks are inserted in constant time, longer ones wait on an
+/// overflow queue. Each level costs 32 list heads (256 bytes) plus a word.
+#define MOS_TIMER_WHEEL_LEVELS          3
+#endif
+
+#ifndef MOS_ENABLE_DEFERRED_TIMERS
+/// Enable timer service thread for deferred timers.
+/// Deferred timer callbacks run in thread context rather than in the tick ISR.
+#define MOS_ENABLE_DEFERRED_TIMERS      false
+#endif
+
+#ifndef MOS_TIMER_THREAD_PRIORITY
+/// Priority of timer service thread (for deferred timers).
+///
+#define MOS_TIMER_THREAD_PRIORITY       0
+#endif
+
+#ifndef MOS_TIMER_THREAD_STACK_SIZE
+/// Stack size of timer service thread (for deferred timers).
+///
+#define MOS_TIMER_THREAD_STACK_SIZE     512
+#endif
+
 #ifndef MOS_HANG_ON_EXCEPTIONS
 /// Hang on exceptions.
 /// Can be used in systems with watchdog timer reset to reboot
@@ -10,6 +10,8 @@
 /// Blocking message queues featuring optional prioritized channels.
 /// Allows for multiple writer AND multiple reader contexts.
 /// Provides blocking and interrupt-safe non-blocking modes.
+/// Slots may also be written and read in place via reserve / commit and
+/// peek / release, avoiding a copy through an intermediate buffer.
 
 #ifndef _MOS_QUEUE_H_
 #define _MOS_QUEUE_H_
@@ -27,8 +29,28 @@ typedef struct MosQueue {
     u16         elmSize;
     u16         channel;
     MosSignal * pSignal;
+    u16         tailClaimed;
+    u16         tailFinished;
+    u16         headClaimed;
+    u16         headFinished;
 } MosQueue;
 
+// Single pool of messages delivered in priority order
+typedef struct MosPriQueue {
+    MosSem      semFree;
+    MosSem      semMsg;
+    MosList   * pPriLists;
+    MosList     freeList;
+    u32         priMap;
+    u16         elmSize;
+    u16         numPri;
+} MosPriQueue;
+
+/// Buffer size in bytes needed by a priority queue.
+///
+#define MOS_PRI_QUEUE_BUF_SIZE(elmSize, numElm, numPri) \
+    ((numPri) * sizeof(MosList) + (numElm) * (sizeof(MosLink) + (elmSize)))
+
 //
 // Message Queues
 //
@@ -62,6 +84,82 @@ MOS_ISR_SAFE bool mosTryReceiveFromQueue(MosQueue * pQueue, void * pData);
 /// \return true if message received, false on timeout.
 bool mosReceiveFromQueueOrTO(MosQueue * pQueue, void * pData, u32 ticks);
 
+//
+// Batched access
+//
+// Each call moves up to count elements, as many as are available, with one
+// semaphore adjustment.  Data is copied with interrupts disabled in chunks of
+// up to MOS_QUEUE_COPY_CHUNK_WORDS words (at least one element), bounding
+// interrupt latency whatever the count.  Messages from other contexts may be
+// interleaved between chunks.  Blocking and timeout forms wait only for the
+// first element.
+//
+
+/// Send up to count messages from array pData, blocking if queue full.
+/// \return number of messages sent, at least one if count is non-zero.
+u32 mosSendManyToQueue(MosQueue * pQueue, const void * pData, u32 count);
+
+/// Attempt to send up to count messages from array pData, non-blocking.
+/// \return number of messages sent, zero if queue full.
+MOS_ISR_SAFE u32 mosTrySendManyToQueue(MosQueue * pQueue, const void * pData, u32 count);
+
+/// Send up to count messages from array pData with timeout.
+/// \return number of messages sent, zero on timeout.
+u32 mosSendManyToQueueOrTO(MosQueue * pQueue, const void * pData, u32 count, u32 ticks);
+
+/// Receive up to count messages into array pData, blocking if queue empty.
+/// \return number of messages received, at least one if count is non-zero.
+u32 mosReceiveManyFromQueue(MosQueue * pQueue, void * pData, u32 count);
+
+/// Attempt to receive up to count messages into array pData, non-blocking.
+/// \return number of messages received, zero if queue empty.
+MOS_ISR_SAFE u32 mosTryReceiveManyFromQueue(MosQueue * pQueue, void * pData, u32 count);
+
+/// Receive up to count messages into array pData with timeout.
+/// \return number of messages received, zero on timeout.
+u32 mosReceiveManyFromQueueOrTO(MosQueue * pQueue, void * pData, u32 count, u32 ticks);
+
+//
+// Zero-copy access
+//
+// Slots are handed out in ring order.  Committed (or released) slots, and
+// any messages copied in (or out) behind them, become visible to readers (or
+// writers) only once every outstanding reservation (or peek) has been
+// committed (or released), so hold slots briefly.
+//
+
+/// Reserve next slot in queue for writing in place, blocking if queue full.
+/// \return pointer to slot of element size, commit with mosCommitQueueSlot().
+void * mosReserveQueueSlot(MosQueue * pQueue);
+
+/// Attempt to reserve next slot in queue for writing in place, non-blocking.
+/// \return pointer to slot, NULL if queue full.
+MOS_ISR_SAFE void * mosTryReserveQueueSlot(MosQueue * pQueue);
+
+/// Reserve next slot in queue for writing in place with timeout.
+/// \return pointer to slot, NULL on timeout.
+void * mosReserveQueueSlotOrTO(MosQueue * pQueue, u32 ticks);
+
+/// Commit a slot obtained from one of the reserve calls, sending it.
+///
+MOS_ISR_SAFE void mosCommitQueueSlot(MosQueue * pQueue);
+
+/// Peek at next message in queue in place, blocking if queue empty.
+/// \return pointer to slot of element size, release with mosReleaseQueueSlot().
+void * mosPeekQueue(MosQueue * pQueue);
+
+/// Attempt to peek at next message in queue in place, non-blocking.
+/// \return pointer to slot, NULL if queue empty.
+MOS_ISR_SAFE void * mosTryPeekQueue(MosQueue * pQueue);
+
+/// Peek at next message in queue in place with timeout.
+/// \return pointer to slot, NULL on timeout.
+void * mosPeekQueueOrTO(MosQueue * pQueue, u32 ticks);
+
+/// Release a slot obtained from one of the peek calls, returning it to writers.
+///
+MOS_ISR_SAFE void mosReleaseQueueSlot(MosQueue * pQueue);
+
 /// Sets signal channel to raise when sending to queue.
 /// Lower channel numbers have higher priorities.
 /// \param channel channel number to set.  Signal bit is (1 << channel).
@@ -75,6 +173,60 @@ s16 mosWaitOnMultiQueue(MosSignal * pSignal, u32 * pFlags);
 /// \return highest priority channel number and updated flags, -1 for timeout.
 s16 mosWaitOnMultiQueueOrTO(MosSignal * pSignal, u32 * pFlags, u32 ticks);
 
+//
+// Priority Queues
+//
+// Each message carries a priority, 0 being highest, and receivers always get
+// the highest priority pending message, FIFO within a priority.  All
+// priorities share a single pool of elements.  Send and receive are O(1).
+//
+
+/// Set buffer to use for priority queue, element size, number of elements
+/// and number of priorities (up to 32).  Buffer must be sized with
+/// MOS_PRI_QUEUE_BUF_SIZE() and aligned to 4 bytes.
+/// \note Element size must be a multiple of 4 (32-bits).
+void mosInitPriQueue(MosPriQueue * pQueue, void * pBuffer, u32 elmSize, u32 numElm, u32 numPri);
+
+/// Send message with priority to queue, blocking if queue full.
+///
+void mosSendToPriQueue(MosPriQueue * pQueue, const void * pData, u32 pri);
+
+/// Attempt to send message with priority to queue, non-blocking.
+/// \return true if message sent.
+MOS_ISR_SAFE bool mosTrySendToPriQueue(MosPriQueue * pQueue, const void * pData, u32 pri);
+
+/// Send message with priority to queue with timeout.
+/// \return true if message sent, false on timeout.
+bool mosSendToPriQueueOrTO(MosPriQueue * pQueue, const void * pData, u32 pri, u32 ticks);
+
+/// Receive highest priority message from queue, blocking if queue empty.
+/// \param pPri if not NULL receives priority of message.
+void mosReceiveFromPriQueue(MosPriQueue * pQueue, void * pData, u32 * pPri);
+
+/// Attempt to receive highest priority message from queue.
+/// \return true if message received, false if empty.
+MOS_ISR_SAFE bool mosTryReceiveFromPriQueue(MosPriQueue * pQueue, void * pData, u32 * pPri);
+
+/// Receive highest priority message from queue with timeout.
+/// \return true if message received, false on timeout.
+bool mosReceiveFromPriQueueOrTO(MosPriQueue * pQueue, void * pData, u32 * pPri, u32 ticks);
+
+//
+// Wait Sets
+//
+
+/// Register queue with wait set, ready while messages are pending.
+///
+MOS_INLINE void mosAddQueueToWaitSet(MosWaitSet * pSet, MosWaitSetMember * pMember, MosQueue * pQueue) {
+    mosAddSemToWaitSet(pSet, pMember, &pQueue->semHead);
+}
+
+/// Register priority queue with wait set, ready while messages are pending.
+///
+MOS_INLINE void mosAddPriQueueToWaitSet(MosWaitSet * pSet, MosWaitSetMember * pMember, MosPriQueue * pQueue) {
+    mosAddSemToWaitSet(pSet, pMember, &pQueue->semMsg);
+}
+
 //
 // Queues with 32-bit data
 //
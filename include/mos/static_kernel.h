@@ -19,6 +19,7 @@
 enum {
     MOS_THREAD_PRIORITY_HI = 0,
     MOS_THREAD_PRIORITY_LO = MOS_MAX_THREAD_PRIORITIES - 1,
+    MOS_NO_PREEMPT_THRESHOLD = 0xff,
 };
 
 typedef enum {
@@ -31,10 +32,13 @@ typedef enum {
 typedef enum {
     MOS_EVENT_SCHEDULER_ENTRY,
     MOS_EVENT_SCHEDULER_EXIT,
-    MOS_EVENT_TICK
+    MOS_EVENT_TICK,
+    MOS_EVENT_DEADLINE_MISS
 } MosEvent;
 
 typedef struct MosTimer MosTimer;
+typedef struct MosISREvent MosISREvent;
+typedef struct MosWaitSetMember MosWaitSetMember;
 
 // Callbacks
 typedef s32 (MosThreadEntry)(s32 arg);
@@ -43,40 +47,137 @@ typedef void (MosRawVPrintfHook)(const char * pFmt, va_list args);
 typedef void (MosSleepHook)(void);
 typedef void (MosWakeHook)(void);
 typedef void (MosEventHook)(MosEvent evt, u32 val);
+typedef void (MosISREventHandler)(MosISREvent * pEvt);
 
 // Mos Thread
 typedef struct MosThread {
 #if (MOS_ARM_RTOS_ON_NON_SECURE_SIDE == true)
-    u32       rsvd[21];
+    u32       rsvd[36];
 #else
-    u32       rsvd[20];
+    u32       rsvd[35];
 #endif
     void    * pUser;         /// User data pointer, set to NULL after thread initialization
 } MosThread;
 
+// Queue of threads pending on a blocking primitive, highest priority first.
+//   With MOS_PEND_QUEUE_BUCKETS the last thread of each priority present is
+//   tracked so threads are queued without walking the list.
+typedef struct MosPendQ {
+    MosList     list;
+#if (MOS_PEND_QUEUE_BUCKETS == true)
+    u32         map;
+    MosLink   * pTail[MOS_MAX_THREAD_PRIORITIES];
+#endif
+} MosPendQ;
+
+// Link of a held lock on the list of locks its owner inherits priority from
+typedef struct MosOwnLink {
+    MosLink             link;
+    struct MosRwLock  * pRwLock;  // NULL for mutexes
+} MosOwnLink;
+
 // Blocking mutex supporting recursion
 typedef struct MosMutex {
     MosThread * pOwner;
     s32         depth;
-    MosList     pendQ;
+    MosPendQ    pendQ;
+    MosOwnLink  ownLink;
 } MosMutex;
 
+// Immediate priority ceiling mutex supporting recursion
+typedef struct MosCeilingMutex {
+    MosMutex            mtx;
+    MosThreadPriority   ceiling;
+    MosThreadPriority   savedThreshold;
+    u16                 pad;
+} MosCeilingMutex;
+
+// Condition variable bound to a mutex
+typedef struct MosCondVar {
+    MosMutex  * pMtx;
+    MosPendQ    pendQ;
+} MosCondVar;
+
+// Writer or reader holding a reader-writer lock
+typedef struct MosRwLockHold {
+    MosThread * pThd;
+    MosOwnLink  ownLink;
+} MosRwLockHold;
+
+// Reader-writer lock with writer preference
+typedef struct MosRwLock {
+    u32             state;
+    MosRwLockHold   writer;
+    MosRwLockHold   readers[MOS_RWLOCK_READER_SLOTS];
+    MosPendQ        pendQ;
+} MosRwLock;
+
 typedef struct MosSem {
-    u32      value;
-    MosList  pendQ;
-    MosLink  evtLink;
+    u32                value;
+    MosPendQ           pendQ;
+    MosLink            evtLink;
+    MosWaitSetMember * pMember;
 } MosSem;
 
 typedef MosSem MosSignal;
 
+typedef struct MosEventGroup {
+    u32         flags;
+    MosPendQ    pendQ;
+    MosLink     evtLink;
+} MosEventGroup;
+
+typedef struct MosISREvent {
+    MosLink              evtLink;
+    MosISREventHandler * pHandler;   /// Invoked by scheduler after posting
+    void               * pUser;      /// User data pointer for handler
+} MosISREvent;
+
+// Wait set of kernel objects, and an object registered with a wait set
+typedef struct MosWaitSet {
+    MosSem             sem;
+    MosList            readyQ;
+    MosWaitSetMember * pLast;
+} MosWaitSet;
+
+typedef struct MosWaitSetMember {
+    MosLink      readyLink;
+    MosWaitSet * pSet;
+    void       * pObj;        /// Registered object
+    u32          type;
+    MosTimerCallback * pTmrCallback;  /// Timer callback displaced while registered
+} MosWaitSetMember;
+
+enum {
+    MOS_EVENT_GROUP_WAIT_ANY   = 0,   /// Wake when any flag in mask is set
+    MOS_EVENT_GROUP_WAIT_ALL   = 1,   /// Wake when all flags in mask are set
+    MOS_EVENT_GROUP_AUTO_CLEAR = 2,   /// Clear matched flags upon wake
+};
+
+typedef enum {
+    MOS_NOTIFY_SET_BITS,    /// Bitwise OR value into notification word
+    MOS_NOTIFY_INCREMENT,   /// Increment notification word (value ignored)
+    MOS_NOTIFY_OVERWRITE,   /// Overwrite notification word with value
+} MosNotifyAction;
+
 typedef struct MosTimer {
     u32                ticks;
     u32                wakeTick;
     MosPmLink          tmrLink;
     MosTimerCallback * pCallback;   /// Callback function
     void             * pUser;       /// User data pointer for callback
+    MosWaitSetMember * pMember;     /// Wait set member (if registered)
 } MosTimer;
 
+typedef struct MosPeriodic {
+    u32  period;         /// Period in ticks
+    u32  lastRelease;    /// Tick of most recent release
+    u32  releaseCount;   /// Number of releases
+    u32  overrunCount;   /// Number of releases that occurred late
+    u32  lastJitter;     /// Cycles from release tick to thread running (last release)
+    u32  maxJitter;      /// Cycles from release tick to thread running (worst case)
+} MosPeriodic;
+
 /// Initialize MOS Microkernel.
 /// In general this call must precede all other calls into the MOS microkernel.
 /// \note Interrupt priority group settings should be configured prior to this call.
@@ -119,6 +220,12 @@ MOS_ISR_SAFE void mosDelayMicroseconds(u32 usec);
 /// Initialize a timer instance.
 ///    Supply a ISR Safe callback function to be called upon timer expiration.
 void mosInitTimer(MosTimer * pTmr, MosTimerCallback * pCallback);
+#if (MOS_ENABLE_DEFERRED_TIMERS == true)
+/// Initialize a deferred timer instance.
+///    Callback is invoked by the timer service thread rather than the tick ISR,
+///    keeping the tick ISR short. Callbacks should not block.
+void mosInitDeferredTimer(MosTimer * pTmr, MosTimerCallback * pCallback);
+#endif
 /// Set Timer to expire after a number of ticks.
 ///
 void mosSetTimer(MosTimer * pTmr, u32 ticks, void * pUser);
@@ -134,9 +241,42 @@ void mosResetTimer(MosTimer * pTmr);
 /// Obtain pointer to currently running thread.
 ///
 MosThread * mosGetRunningThread(void);
+/// Obtain longest tick ISR duration in cycles since last reset.
+///
+MOS_ISR_SAFE u32 mosGetMaxTickCycles(void);
+MOS_ISR_SAFE void mosResetMaxTickCycles(void);
+/// Obtain number of ticks on which the scheduler was not invoked because
+///   no thread needed to be preempted or round-robined.
+MOS_ISR_SAFE u32 mosGetAvoidedContextSwitchCount(void);
+/// Obtain the most ISR events drained by one scheduler pass and
+///   the longest interrupt disable window while draining them, in cycles.
+MOS_ISR_SAFE void mosGetISREventStats(u32 * pMaxBatch, u32 * pMaxLockCycles);
+MOS_ISR_SAFE void mosResetISREventStats(void);
 /// Delay thread a number of ticks, zero input yields thread (see mosYieldThread).
 ///
 void mosDelayThread(u32 ticks);
+/// Delay thread until tick (*pLastWake + period), then advance *pLastWake by period.
+///   Since wake ticks are absolute, periodic threads do not drift.
+/// \return false if the wake tick has already passed (no delay occurs)
+bool mosDelayUntil(u32 * pLastWake, u32 period);
+#if (MOS_ENABLE_EDF == true)
+/// Set absolute deadline tick of thread, used to order threads in the EDF band.
+///   Threads have no deadline until one is set, and run after those that do.
+///   A passed deadline is reported as a miss once, on the tick it passes while
+///   the thread is runnable, or when the thread blocks, stops or sets another.
+void mosSetThreadDeadline(MosThread * pThd, u32 deadline);
+/// Obtain number of deadline misses of threads in the EDF band.
+///
+MOS_ISR_SAFE u32 mosGetDeadlineMissCount(void);
+#endif
+/// Initialize periodic release helper, first release is one period from now.
+///
+void mosInitPeriodic(MosPeriodic * pPer, u32 period);
+/// Wait for next periodic release, recording release jitter and overruns.
+///   Upon overrun the thread is released immediately and the period restarts.
+///   Threads in the EDF band have their deadline set to the following release.
+/// \return false on overrun
+bool mosWaitForNextPeriod(MosPeriodic * pPer);
 /// Yield to another thread of same priority.
 /// \note Thread yields can be used for cooperative multitasking between threads of the same priority.
 static MOS_INLINE void mosYieldThread(void) {
@@ -188,6 +328,25 @@ MosThreadPriority mosGetThreadPriority(MosThread * pThd);
 /// Change thread priority.
 ///
 void mosChangeThreadPriority(MosThread * pThd, MosThreadPriority pri);
+/// Set preemption threshold of thread. While running, the thread may only be
+///   preempted by threads with priority above (numerically less than) the
+///   threshold. Once such a thread blocks, the preempted thread resumes ahead
+///   of threads below the threshold. Threads under a threshold are not
+///   time-sliced. Set after
+///   mosInitThread() and before mosRunThread() to apply from the start.
+///   MOS_NO_PREEMPT_THRESHOLD (the default) disables the threshold.
+void mosSetPreemptThreshold(MosThread * pThd, MosThreadPriority threshold);
+/// Set round-robin time slice in ticks for threads of given priority.
+/// Zero disables time-slicing, threads then run until they block or yield.
+/// \note pri must be less than MOS_MAX_THREAD_PRIORITIES (asserted).
+void mosSetTimeSlice(MosThreadPriority pri, u32 ticks);
+#if (MOS_ENABLE_CPU_BUDGETS == true)
+/// Limit thread to a CPU budget of cycles per replenishment period (in ticks).
+///   A thread exhausting its budget is suspended until its budget is replenished,
+///   unless it holds a mutex. Overdrawn cycles are deducted from the next period.
+///   Zero cycles removes the limit.
+void mosSetThreadBudget(MosThread * pThd, u32 cycles, u32 period);
+#endif
 /// Waits for thread stop or termination. If a thread terminates abnormally this is
 /// invoked AFTER the termination handler.
 s32 mosWaitForThreadStop(MosThread * pThd);
@@ -213,6 +372,50 @@ void mosUnlockMutex(MosMutex * pMtx);
 void mosRestoreMutex(MosMutex * pMtx);
 bool mosIsMutexOwner(MosMutex * pMtx);
 
+// Immediate priority ceiling mutex
+//   Locking raises the preemption threshold of the caller to the ceiling priority,
+//   which must be at or above the priority of every thread using the mutex. Owners
+//   should not block while holding it, other users then block on the mutex with
+//   priority inheritance. Nested ceiling mutexes unlock in reverse order.
+
+void mosInitCeilingMutex(MosCeilingMutex * pMtx, MosThreadPriority ceiling);
+void mosLockCeilingMutex(MosCeilingMutex * pMtx);
+void mosUnlockCeilingMutex(MosCeilingMutex * pMtx);
+
+// Condition variables
+//   Waiting releases the bound mutex (at any recursion depth) and reacquires it
+//   before returning, so the caller must own the mutex. Signaling wakes the
+//   highest priority waiter, broadcasting wakes all of them. Threads released
+//   while the mutex is held are moved directly onto its pend queue.
+
+void mosInitCondVar(MosCondVar * pCv, MosMutex * pMtx);
+void mosWaitForCondVar(MosCondVar * pCv);
+/// Returns false on timeout (mutex is reacquired in either case)
+bool mosWaitForCondVarOrTO(MosCondVar * pCv, u32 ticks);
+void mosSignalCondVar(MosCondVar * pCv);
+void mosBroadcastCondVar(MosCondVar * pCv);
+
+// Reader-writer lock
+//   Any number of readers or a single writer may hold the lock. Writers have
+//   preference: once a thread is waiting, new readers queue behind it. Waiters
+//   are ordered by priority, and the writer or up to MOS_RWLOCK_READER_SLOTS
+//   readers holding the lock inherit the priority of blocked threads. Those
+//   holds are released if the thread stops or is killed, so termination
+//   handlers must not unlock them. Read locks are not recursive.
+//   Lock and unlock always briefly lock the scheduler: each hold updates the
+//   lock state, the hold record and the list of locks held by the thread
+//   together, which a single compare-and-swap on the state cannot do.
+
+void mosInitRwLock(MosRwLock * pLock);
+void mosReadLock(MosRwLock * pLock);
+/// Returns false on timeout
+bool mosReadLockOrTO(MosRwLock * pLock, u32 ticks);
+void mosReadUnlock(MosRwLock * pLock);
+void mosWriteLock(MosRwLock * pLock);
+/// Returns false on timeout
+bool mosWriteLockOrTO(MosRwLock * pLock, u32 ticks);
+void mosWriteUnlock(MosRwLock * pLock);
+
 // Blocking Semaphores (intended for signaling)
 
 void mosInitSem(MosSem * pSem, u32 startValue);
@@ -224,6 +427,10 @@ void mosWaitForSem(MosSem * pSem);
 bool mosWaitForSemOrTO(MosSem * pSem, u32 ticks);
 MOS_ISR_SAFE bool mosTrySem(MosSem * pSem);
 MOS_ISR_SAFE void mosIncrementSem(MosSem * pSem);
+// Take up to maxCount counts without blocking, returns number taken
+MOS_ISR_SAFE u32 mosTrySemCount(MosSem * pSem, u32 maxCount);
+// Increment count by count, with a single release of pending threads
+MOS_ISR_SAFE void mosAddToSem(MosSem * pSem, u32 count);
 
 // (2) A Signal is a set of 32 single-bit binary semaphores grouped in a u32 word
 //     Operation is single-reader / multiple-writer
@@ -237,6 +444,10 @@ u32 mosWaitForSignalOrTO(MosSignal * pSignal, u32 ticks);
 MOS_ISR_SAFE u32 mosPollSignal(MosSignal * pSignal);
 MOS_ISR_SAFE void mosRaiseSignal(MosSignal * pSignal, u32 flags);
 
+/// Obtain index of least significant set bit of a non-zero map.
+///   Avoids the library call __builtin_ctz() becomes on baseline (v6-M).
+MOS_ISR_SAFE u32 mosFindFirstSet(u32 map);
+
 /// Raise signal on a channel. A channel corresponds to one bit in a signal.
 ///
 MOS_ISR_SAFE static MOS_INLINE void mosRaiseSignalForChannel(MosSignal * pSignal, u16 channel) {
@@ -270,6 +481,80 @@ MOS_ISR_SAFE static MOS_INLINE void mosRaiseBinarySem(MosSem * pSem) {
     mosRaiseSignal(pSem, 1);
 }
 
+// Event Groups
+//   A group of 32 event flags that may be set from threads or ISRs. Unlike
+//   signals, multiple threads may wait on different combinations of flags.
+
+void mosInitEventGroup(MosEventGroup * pGrp, u32 flags);
+/// Set flags, waking all threads whose wait conditions become satisfied.
+///
+MOS_ISR_SAFE void mosSetEventFlags(MosEventGroup * pGrp, u32 flags);
+MOS_ISR_SAFE void mosClearEventFlags(MosEventGroup * pGrp, u32 flags);
+MOS_ISR_SAFE u32 mosGetEventFlags(MosEventGroup * pGrp);
+/// Wait for any or all flags in mask (see MOS_EVENT_GROUP_* options).
+///   Mask must be non-zero.
+/// \return flags in mask that satisfied the wait
+u32 mosWaitForEventFlags(MosEventGroup * pGrp, u32 mask, u32 opts);
+/// Wait for any or all flags in mask with timeout.
+/// \return flags in mask that satisfied the wait, or zero on timeout
+u32 mosWaitForEventFlagsOrTO(MosEventGroup * pGrp, u32 mask, u32 opts, u32 ticks);
+
+// Direct-to-thread Notifications
+//   Each thread has a notification word that may be updated by threads or ISRs,
+//   waking the thread directly without the need for a separate semaphore.
+
+/// Update notification word of a thread and wake it if it is waiting.
+///
+MOS_ISR_SAFE void mosNotifyThread(MosThread * pThd, u32 value, MosNotifyAction action);
+/// Wait for notification of running thread, returning the notification word.
+///   Bits set in clearMask are cleared from the notification word upon exit.
+u32 mosWaitForNotify(u32 clearMask);
+/// Wait for notification with timeout, returns false on timeout.
+///   Bits set in clearMask are cleared from the notification word upon exit.
+bool mosWaitForNotifyOrTO(u32 clearMask, u32 * pValue, u32 ticks);
+
+// ISR Events
+//   ISRs may post an event to defer work to the scheduler (PendSV) context,
+//   where the handler runs with interrupts enabled before the next thread is
+//   selected. Kernel objects signaled from ISRs (semaphores, event groups and
+//   notifications) are posted the same way, each type with its own handler.
+
+/// Initialize ISR event with handler.
+///
+void mosInitISREvent(MosISREvent * pEvt, MosISREventHandler * pHandler);
+/// Post ISR event, an event already pending is not posted again.
+///   The handler must not block, but may call ISR safe functions.
+MOS_ISR_SAFE void mosPostISREvent(MosISREvent * pEvt);
+
+// Wait Sets
+//   A thread may block on a wait set of any number of semaphores (and so queues
+//   and signals), thread stops and timers, and is woken with a member that
+//   became ready.  Members are queued as they become ready rather than polled.
+//   A semaphore member returned by a wait is requeued on the next wait while
+//   its count remains non-zero.  Thread stop and timer members are queued once
+//   per stop or expiry.  A wait set should be waited on by a single thread.
+
+void mosInitWaitSet(MosWaitSet * pSet);
+/// Register semaphore or signal, ready while its count (or flags) are non-zero.
+///   An object may be registered with only one wait set at a time.
+void mosAddSemToWaitSet(MosWaitSet * pSet, MosWaitSetMember * pMember, MosSem * pSem);
+/// Register thread, ready once it has stopped.
+///
+void mosAddThreadToWaitSet(MosWaitSet * pSet, MosWaitSetMember * pMember, MosThread * pThd);
+/// Register initialized timer, ready upon each expiry.  The timer callback is
+///   taken over by the wait set until the member is removed.
+void mosAddTimerToWaitSet(MosWaitSet * pSet, MosWaitSetMember * pMember, MosTimer * pTmr);
+void mosRemoveFromWaitSet(MosWaitSetMember * pMember);
+/// Wait for a member of the set to become ready.
+/// \return ready member
+MosWaitSetMember * mosWaitOnWaitSet(MosWaitSet * pSet);
+/// Wait for a member of the set to become ready with timeout.
+/// \return ready member, or NULL on timeout
+MosWaitSetMember * mosWaitOnWaitSetOrTO(MosWaitSet * pSet, u32 ticks);
+/// Return ready member without blocking, or NULL if none ready.
+///
+MOS_ISR_SAFE MosWaitSetMember * mosPollWaitSet(MosWaitSet * pSet);
+
 /// Asserts induce crash if given condition is not satisfied.
 ///
 void mosAssertAt(char * pFile, u32 line);
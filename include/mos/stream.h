@@ -0,0 +1,163 @@
+// Copyright 2021-2023 Matthew C Needes
+// You may not use this source file except in compliance with the
+// terms and conditions contained within the LICENSE file (the
+// "License") included under this distribution.
+
+/// \file  mos/stream.h
+/// \brief MOS Stream and Message Buffers
+///
+/// Byte ring buffers for data that does not fit fixed-size queue elements.
+/// A stream buffer carries a byte stream, waking its reader once a trigger
+/// level is reached.  A message buffer carries variable-length records.
+/// Both are single-writer / single-reader, and provide blocking, timeout and
+/// interrupt-safe non-blocking modes, plus contiguous region accessors for
+/// use with DMA.  An external mutex is required to support multiple readers
+/// or writers.
+/// \note Usable capacity is one byte less than the buffer size.
+
+#ifndef _MOS_STREAM_H_
+#define _MOS_STREAM_H_
+
+#include <mos/static_kernel.h>
+
+// Single-writer / single-reader blocking byte stream
+typedef struct MosStreamBuffer {
+    u8           * pBuf;
+    u32            size;
+    volatile u32   tail;
+    volatile u32   head;
+    u32            trigger;
+    MosSignal      sigData;
+    MosSignal      sigSpace;
+} MosStreamBuffer;
+
+// Single-writer / single-reader blocking variable-length message buffer
+typedef struct MosMessageBuffer {
+    MosStreamBuffer sb;
+    u32             resvTail;
+} MosMessageBuffer;
+
+//
+// Stream Buffers
+//
+
+/// Set buffer to use for stream and trigger level.
+/// Invoke this before calling any other stream buffer API functions.
+/// \param trigger number of bytes that must be present to wake a blocked reader.
+void mosInitStreamBuffer(MosStreamBuffer * pStream, void * pBuffer, u32 size, u32 trigger);
+
+/// Set trigger level, clamped to between one and the stream capacity.
+///
+void mosSetStreamBufferTrigger(MosStreamBuffer * pStream, u32 trigger);
+
+/// Get number of bytes in stream.
+///
+MOS_ISR_SAFE u32 mosGetStreamBufferCount(MosStreamBuffer * pStream);
+
+/// Get number of bytes that may be written to stream.
+///
+MOS_ISR_SAFE u32 mosGetStreamBufferSpace(MosStreamBuffer * pStream);
+
+/// Write all bytes to stream, blocking while stream full.
+///
+void mosWriteToStreamBuffer(MosStreamBuffer * pStream, const void * pData, u32 len);
+
+/// Write as many bytes to stream as fit, non-blocking.
+/// \return number of bytes written.
+MOS_ISR_SAFE u32 mosTryWriteToStreamBuffer(MosStreamBuffer * pStream, const void * pData, u32 len);
+
+/// Write bytes to stream, blocking while stream full, with timeout.
+/// \return number of bytes written, less than len on timeout.
+u32 mosWriteToStreamBufferOrTO(MosStreamBuffer * pStream, const void * pData, u32 len, u32 ticks);
+
+/// Read up to len bytes from stream, blocking until trigger level reached.
+/// \return number of bytes read.
+u32 mosReadFromStreamBuffer(MosStreamBuffer * pStream, void * pData, u32 len);
+
+/// Read up to len bytes from stream, non-blocking.
+/// \return number of bytes read.
+MOS_ISR_SAFE u32 mosTryReadFromStreamBuffer(MosStreamBuffer * pStream, void * pData, u32 len);
+
+/// Read up to len bytes from stream, blocking until trigger level reached
+/// with timeout.  On timeout any bytes present are read.
+/// \return number of bytes read.
+u32 mosReadFromStreamBufferOrTO(MosStreamBuffer * pStream, void * pData, u32 len, u32 ticks);
+
+/// Get contiguous free region at stream tail, e.g. for a DMA write.
+/// \return size of region in bytes, commit with mosCommitStreamBufferWrite().
+MOS_ISR_SAFE u32 mosGetStreamBufferWriteRegion(MosStreamBuffer * pStream, void ** ppRegion);
+
+/// Commit len bytes written to region from mosGetStreamBufferWriteRegion().
+///
+MOS_ISR_SAFE void mosCommitStreamBufferWrite(MosStreamBuffer * pStream, u32 len);
+
+/// Get contiguous filled region at stream head, e.g. for a DMA read.
+/// \return size of region in bytes, release with mosReleaseStreamBufferRead().
+MOS_ISR_SAFE u32 mosGetStreamBufferReadRegion(MosStreamBuffer * pStream, const void ** ppRegion);
+
+/// Release len bytes read from region from mosGetStreamBufferReadRegion().
+///
+MOS_ISR_SAFE void mosReleaseStreamBufferRead(MosStreamBuffer * pStream, u32 len);
+
+//
+// Message Buffers
+//
+// Each message is stored contiguously behind a 2-byte length, so message
+// data may be accessed in place.  Messages up to mosGetMaxMessageSize()
+// bytes, a little under half the buffer size, are guaranteed to fit once
+// the buffer drains.  Zero-length messages are not supported.
+//
+
+/// Set buffer to use for messages.
+/// Invoke this before calling any other message buffer API functions.
+void mosInitMessageBuffer(MosMessageBuffer * pMsgBuf, void * pBuffer, u32 size);
+
+/// Get largest message size that may be sent.
+///
+MOS_ISR_SAFE u32 mosGetMaxMessageSize(MosMessageBuffer * pMsgBuf);
+
+/// Send message, blocking while there is no room for it.
+/// \return false if message larger than mosGetMaxMessageSize().
+bool mosSendToMessageBuffer(MosMessageBuffer * pMsgBuf, const void * pData, u32 len);
+
+/// Attempt to send message, non-blocking.
+/// \return true if message sent.
+MOS_ISR_SAFE bool mosTrySendToMessageBuffer(MosMessageBuffer * pMsgBuf, const void * pData, u32 len);
+
+/// Send message with timeout.
+/// \return true if message sent, false on timeout.
+bool mosSendToMessageBufferOrTO(MosMessageBuffer * pMsgBuf, const void * pData, u32 len, u32 ticks);
+
+/// Get size of next message.
+/// \return message size, zero if empty.
+MOS_ISR_SAFE u32 mosGetNextMessageSize(MosMessageBuffer * pMsgBuf);
+
+/// Receive message, blocking if empty.
+/// \return message size, zero if message larger than maxLen (left in buffer).
+u32 mosReceiveFromMessageBuffer(MosMessageBuffer * pMsgBuf, void * pData, u32 maxLen);
+
+/// Attempt to receive message, non-blocking.
+/// \return message size, zero if empty or message larger than maxLen.
+MOS_ISR_SAFE u32 mosTryReceiveFromMessageBuffer(MosMessageBuffer * pMsgBuf, void * pData, u32 maxLen);
+
+/// Receive message with timeout.
+/// \return message size, zero on timeout or if message larger than maxLen.
+u32 mosReceiveFromMessageBufferOrTO(MosMessageBuffer * pMsgBuf, void * pData, u32 maxLen, u32 ticks);
+
+/// Attempt to reserve contiguous space for a message of len bytes, non-blocking.
+/// \return pointer to message data, NULL if no room. Send with mosCommitMessage().
+MOS_ISR_SAFE void * mosTryReserveMessage(MosMessageBuffer * pMsgBuf, u32 len);
+
+/// Send message reserved by mosTryReserveMessage().
+///
+MOS_ISR_SAFE void mosCommitMessage(MosMessageBuffer * pMsgBuf);
+
+/// Attempt to peek at next message in place, non-blocking.
+/// \return pointer to message data, NULL if empty. Release with mosReleaseMessage().
+MOS_ISR_SAFE const void * mosTryPeekMessage(MosMessageBuffer * pMsgBuf, u32 * pLen);
+
+/// Release message peeked by mosTryPeekMessage().
+///
+MOS_ISR_SAFE void mosReleaseMessage(MosMessageBuffer * pMsgBuf);
+
+#endif
@@ -61,7 +61,7 @@ typedef struct Entry2 {
 } Entry2;
 
 typedef struct Registry {
-    MosMutex  mutex;
+    MosRwLock lock;
     Entry   * root;
     MosHeap * heap;
     char      delimiter;
@@ -195,7 +195,7 @@ FindNext: {
 }
 
 MosEntry mosRegistryInit(MosHeap * heap, char delimiter) {
-    mosInitMutex(&reg.mutex);
+    mosInitRwLock(&reg.lock);
     reg.heap      = heap;
     reg.delimiter = delimiter;
     reg.root      = (Entry *)mosAlloc(reg.heap, sizeof(Entry));
@@ -207,9 +207,9 @@ MosEntry mosRegistryInit(MosHeap * heap, char delimiter) {
 }
 
 MosEntry mosFindEntry(MosEntry root, const char * path) {
-    mosLockMutex(&reg.mutex);
+    mosReadLock(&reg.lock);
     MosEntry entry = FindEntry((Entry *)root, path);
-    mosUnlockMutex(&reg.mutex);
+    mosReadUnlock(&reg.lock);
     return entry;
 }
 
@@ -217,19 +217,19 @@ MosEntry mosFindEntry(MosEntry root, const char * path) {
 
 bool mosSetStringEntry(MosEntry root, const char * path, const char * str) {
     bool success = false;
-    mosLockMutex(&reg.mutex);
+    mosWriteLock(&reg.lock);
     Entry * entry = (Entry *)CreateEntry((Entry *)root, path, (const u8 *)str, strlen(str) + 1);
     if (entry) {
         entry->type = MosEntryTypeString;
         success = true;
     }
-    mosUnlockMutex(&reg.mutex);
+    mosWriteUnlock(&reg.lock);
     return success;
 }
 
 bool mosGetStringEntry(MosEntry root, const char * path, char * data, u32 * size) {
     bool success = false;
-    mosLockMutex(&reg.mutex);
+    mosReadLock(&reg.lock);
     Entry * entry = FindEntry((Entry *)root, path);
     if (entry && entry->type == MosEntryTypeString) {
         if (*size >= entry->blob.size) {
@@ -238,46 +238,46 @@ bool mosGetStringEntry(MosEntry root, const char * path, char * data, u32 * size
         }
         *size = entry->blob.size;
     }
-    mosUnlockMutex(&reg.mutex);
+    mosReadUnlock(&reg.lock);
     return success;
 }
 
 #if 0
 bool mosSetIntegerEntry(MosEntry root, const char * path, const s64 data) {
     bool success = false;
-    mosLockMutex(&reg.mutex);
+    mosWriteLock(&reg.lock);
     Entry * entry = FindEntry((Entry *)root, path);
     if (entry && entry->type == MosEntryTypeInteger) {
         *data = entry->int_value;
         success = true;
     }
-    mosUnlockMutex(&reg.mutex);
+    mosWriteUnlock(&reg.lock);
     return success;
 }
 #endif
 
 bool mosGetIntegerEntry(MosEntry root, const char * path, s64 * data) {
     bool success = false;
-    mosLockMutex(&reg.mutex);
+    mosReadLock(&reg.lock);
     Entry * entry = FindEntry((Entry *)root, path);
     if (entry && entry->type == MosEntryTypeInteger) {
         *data = entry->int_value;
         success = true;
     }
-    mosUnlockMutex(&reg.mutex);
+    mosReadUnlock(&reg.lock);
     return success;
 }
 
 #if 0
 
 bool mosPrintEntryAsString(MosEntry entry, (*PrintfFunc)(const char *, ...)) {
-    mosLockMutex(&reg.mutex);
-    mosUnlockMutex(&reg.mutex);
+    mosReadLock(&reg.lock);
+    mosReadUnlock(&reg.lock);
 }
 
 bool mosSetEntryWithString(MosEntry entry, const char * value) {
-    mosLockMutex(&reg.mutex);
-    mosUnlockMutex(&reg.mutex);
+    mosWriteLock(&reg.lock);
+    mosWriteUnlock(&reg.lock);
 }
 
 #endif
@@ -10,20 +10,117 @@
 
 #include <mos/queue.h>
 
-MOS_ISR_SAFE static void CopyToTail(MosQueue * pQueue, const u32 * pData) {
+// Copying sends and receives move message data with interrupts disabled, so
+// they complete in one step and are never held up by other contexts.  Batches
+// are copied in chunks of up to MOS_QUEUE_COPY_CHUNK_WORDS, each its own step.
+// Zero-copy reservations and peeks instead claim slots in ring order under a
+// short critical section and fill or read them with interrupts enabled.
+// Claimed slots are published to the opposite semaphore only once every
+// outstanding claim on that side has been finished, keeping published slots
+// contiguous.  Slots copied while claims are outstanding are published along
+// with them.
+
+MOS_ISR_SAFE static MOS_INLINE void AdvanceSlots(MosQueue * pQueue, u32 ** ppNext, u32 count) {
+    *ppNext += count * pQueue->elmSize;
+    if (*ppNext >= pQueue->pEnd) *ppNext -= pQueue->pEnd - pQueue->pBegin;
+}
+
+MOS_ISR_SAFE static MOS_INLINE void PublishSlots(MosSem * pSem, u32 count) {
+    if (count == 1) mosIncrementSem(pSem);
+    else mosAddToSem(pSem, count);
+}
+
+MOS_ISR_SAFE static u32 * ClaimSlot(MosQueue * pQueue, u32 ** ppNext, u16 * pClaimed) {
     u32 mask = mosDisableInterrupts();
-    for (u32 ix = 0; ix < pQueue->elmSize; ix++) *pQueue->pTail++ = *pData++;
-    if (pQueue->pTail == pQueue->pEnd) pQueue->pTail = pQueue->pBegin;
-    asm volatile ( "dmb" );
+    u32 * pSlot = *ppNext;
+    AdvanceSlots(pQueue, ppNext, 1);
+    *pClaimed += 1;
     mosEnableInterrupts(mask);
+    return pSlot;
 }
 
-MOS_ISR_SAFE static void CopyFromHead(MosQueue * pQueue, u32 * pData) {
-    u32 mask = mosDisableInterrupts();
-    for (u32 ix = 0; ix < pQueue->elmSize; ix++) *pData++ = *pQueue->pHead++;
-    if (pQueue->pHead == pQueue->pEnd) pQueue->pHead = pQueue->pBegin;
+MOS_ISR_SAFE static void FinishSlot(u16 * pClaimed, u16 * pFinished, MosSem * pSem) {
+    u32 publish = 0;
     asm volatile ( "dmb" );
+    u32 mask = mosDisableInterrupts();
+    *pFinished += 1;
+    if (*pFinished == *pClaimed) {
+        publish = *pFinished;
+        *pClaimed = 0;
+        *pFinished = 0;
+    }
     mosEnableInterrupts(mask);
+    PublishSlots(pSem, publish);
+}
+
+// Account for slots copied in a critical section.  Returns number of slots to
+//   publish, zero if they are held back by outstanding claims.
+MOS_ISR_SAFE static MOS_INLINE u32 FinishCopiedSlots(u16 * pClaimed, u16 * pFinished, u32 count) {
+    if (*pClaimed == 0) return count;
+    *pClaimed += count;
+    *pFinished += count;
+    return 0;
+}
+
+MOS_ISR_SAFE static void CopySlot(u32 * pDst, const u32 * pSrc, u32 elmSize) {
+    for (u32 ix = 0; ix < elmSize; ix++) *pDst++ = *pSrc++;
+}
+
+// Copy size words between ring at pSlot and a linear buffer, wrapping at end of ring
+MOS_ISR_SAFE static void CopyToRing(MosQueue * pQueue, u32 * pSlot, const u32 * pSrc, u32 size) {
+    u32 first = pQueue->pEnd - pSlot;
+    if (first > size) first = size;
+    CopySlot(pSlot, pSrc, first);
+    CopySlot(pQueue->pBegin, pSrc + first, size - first);
+}
+
+MOS_ISR_SAFE static void CopyFromRing(MosQueue * pQueue, u32 * pDst, const u32 * pSlot, u32 size) {
+    u32 first = pQueue->pEnd - pSlot;
+    if (first > size) first = size;
+    CopySlot(pDst, pSlot, first);
+    CopySlot(pDst + first, pQueue->pBegin, size - first);
+}
+
+// Number of elements to copy in one critical section, at least one
+MOS_ISR_SAFE static MOS_INLINE u32 CopyChunk(MosQueue * pQueue, u32 count) {
+    u32 chunk = MOS_QUEUE_COPY_CHUNK_WORDS / pQueue->elmSize;
+    if (chunk == 0) chunk = 1;
+    return (count < chunk) ? count : chunk;
+}
+
+// Slots were licensed by the caller, so other contexts may interleave their
+//   messages between chunks without disturbing the order of this batch.
+MOS_ISR_SAFE static u32 SendMany(MosQueue * pQueue, const u32 * pData, u32 count) {
+    for (u32 left = count; left; ) {
+        u32 chunk = CopyChunk(pQueue, left);
+        u32 mask = mosDisableInterrupts();
+        CopyToRing(pQueue, pQueue->pTail, pData, chunk * pQueue->elmSize);
+        AdvanceSlots(pQueue, &pQueue->pTail, chunk);
+        u32 publish = FinishCopiedSlots(&pQueue->tailClaimed, &pQueue->tailFinished, chunk);
+        asm volatile ( "dmb" );
+        mosEnableInterrupts(mask);
+        PublishSlots(&pQueue->semHead, publish);
+        pData += chunk * pQueue->elmSize;
+        left -= chunk;
+    }
+    if (pQueue->pSignal) mosRaiseSignalForChannel(pQueue->pSignal, pQueue->channel);
+    return count;
+}
+
+MOS_ISR_SAFE static u32 ReceiveMany(MosQueue * pQueue, u32 * pData, u32 count) {
+    for (u32 left = count; left; ) {
+        u32 chunk = CopyChunk(pQueue, left);
+        u32 mask = mosDisableInterrupts();
+        CopyFromRing(pQueue, pData, pQueue->pHead, chunk * pQueue->elmSize);
+        AdvanceSlots(pQueue, &pQueue->pHead, chunk);
+        u32 publish = FinishCopiedSlots(&pQueue->headClaimed, &pQueue->headFinished, chunk);
+        asm volatile ( "dmb" );
+        mosEnableInterrupts(mask);
+        PublishSlots(&pQueue->semTail, publish);
+        pData += chunk * pQueue->elmSize;
+        left -= chunk;
+    }
+    return count;
 }
 
 void mosInitQueue(MosQueue * pQueue, void * pBuffer, u32 elmSize, u32 numElm) {
@@ -34,6 +131,10 @@ void mosInitQueue(MosQueue * pQueue, void * pBuffer, u32 elmSize, u32 numElm) {
     pQueue->pTail    = pQueue->pBegin;
     pQueue->pHead    = pQueue->pBegin;
     pQueue->pSignal  = NULL;
+    pQueue->tailClaimed  = 0;
+    pQueue->tailFinished = 0;
+    pQueue->headClaimed  = 0;
+    pQueue->headFinished = 0;
     mosInitSem(&pQueue->semTail, numElm);
     mosInitSem(&pQueue->semHead, 0);
 }
@@ -43,59 +144,220 @@ void mosSetMultiQueueChannel(MosQueue * pQueue, MosSignal * pSignal, u16 channel
     pQueue->pSignal = pSignal;
 }
 
-void mosSendToQueue(MosQueue * pQueue, const void * pData) {
+void * mosReserveQueueSlot(MosQueue * pQueue) {
     // After taking semaphore context has a "license to write one entry,"
-    // but it still must wait if another context is trying to do the same
-    // thing in a thread.
+    // the slot itself is claimed in ring order.
     mosWaitForSem(&pQueue->semTail);
-    CopyToTail(pQueue, pData);
-    mosIncrementSem(&pQueue->semHead);
+    return ClaimSlot(pQueue, &pQueue->pTail, &pQueue->tailClaimed);
+}
+
+MOS_ISR_SAFE void * mosTryReserveQueueSlot(MosQueue * pQueue) {
+    if (!mosTrySem(&pQueue->semTail)) return NULL;
+    return ClaimSlot(pQueue, &pQueue->pTail, &pQueue->tailClaimed);
+}
+
+void * mosReserveQueueSlotOrTO(MosQueue * pQueue, u32 ticks) {
+    if (!mosWaitForSemOrTO(&pQueue->semTail, ticks)) return NULL;
+    return ClaimSlot(pQueue, &pQueue->pTail, &pQueue->tailClaimed);
+}
+
+MOS_ISR_SAFE void mosCommitQueueSlot(MosQueue * pQueue) {
+    FinishSlot(&pQueue->tailClaimed, &pQueue->tailFinished, &pQueue->semHead);
     if (pQueue->pSignal) mosRaiseSignalForChannel(pQueue->pSignal, pQueue->channel);
 }
 
+void * mosPeekQueue(MosQueue * pQueue) {
+    mosWaitForSem(&pQueue->semHead);
+    return ClaimSlot(pQueue, &pQueue->pHead, &pQueue->headClaimed);
+}
+
+MOS_ISR_SAFE void * mosTryPeekQueue(MosQueue * pQueue) {
+    if (!mosTrySem(&pQueue->semHead)) return NULL;
+    return ClaimSlot(pQueue, &pQueue->pHead, &pQueue->headClaimed);
+}
+
+void * mosPeekQueueOrTO(MosQueue * pQueue, u32 ticks) {
+    if (!mosWaitForSemOrTO(&pQueue->semHead, ticks)) return NULL;
+    return ClaimSlot(pQueue, &pQueue->pHead, &pQueue->headClaimed);
+}
+
+MOS_ISR_SAFE void mosReleaseQueueSlot(MosQueue * pQueue) {
+    FinishSlot(&pQueue->headClaimed, &pQueue->headFinished, &pQueue->semTail);
+}
+
+void mosSendToQueue(MosQueue * pQueue, const void * pData) {
+    // After taking semaphore context has a "license to write one entry"
+    mosWaitForSem(&pQueue->semTail);
+    SendMany(pQueue, pData, 1);
+}
+
 MOS_ISR_SAFE bool mosTrySendToQueue(MosQueue * pQueue, const void * pData) {
     // MosTrySendToQueue() and MosTryReceiveFromQueue() are ISR safe since
     // they do not block and interrupts are locked out when queues are being
     // manipulated.
     if (!mosTrySem(&pQueue->semTail)) return false;
-    CopyToTail(pQueue, pData);
-    mosIncrementSem(&pQueue->semHead);
-    if (pQueue->pSignal) mosRaiseSignalForChannel(pQueue->pSignal, pQueue->channel);
+    SendMany(pQueue, pData, 1);
     return true;
 }
 
 bool mosSendToQueueOrTO(MosQueue * pQueue, const void * pData, u32 ticks) {
-    if (mosWaitForSemOrTO(&pQueue->semTail, ticks)) {
-        CopyToTail(pQueue, pData);
-        mosIncrementSem(&pQueue->semHead);
-        if (pQueue->pSignal) mosRaiseSignalForChannel(pQueue->pSignal, pQueue->channel);
-        return true;
-    }
-    return false;
+    if (!mosWaitForSemOrTO(&pQueue->semTail, ticks)) return false;
+    SendMany(pQueue, pData, 1);
+    return true;
 }
 
 void mosReceiveFromQueue(MosQueue * pQueue, void * pData) {
     mosWaitForSem(&pQueue->semHead);
-    CopyFromHead(pQueue, pData);
-    mosIncrementSem(&pQueue->semTail);
+    ReceiveMany(pQueue, pData, 1);
 }
 
 MOS_ISR_SAFE bool mosTryReceiveFromQueue(MosQueue * pQueue, void * pData) {
-    if (mosTrySem(&pQueue->semHead)) {
-        CopyFromHead(pQueue, pData);
-        mosIncrementSem(&pQueue->semTail);
-        return true;
-    }
-    return false;
+    if (!mosTrySem(&pQueue->semHead)) return false;
+    ReceiveMany(pQueue, pData, 1);
+    return true;
 }
 
 bool mosReceiveFromQueueOrTO(MosQueue * pQueue, void * pData, u32 ticks) {
-    if (mosWaitForSemOrTO(&pQueue->semHead, ticks)) {
-        CopyFromHead(pQueue, pData);
-        mosIncrementSem(&pQueue->semTail);
-        return true;
+    if (!mosWaitForSemOrTO(&pQueue->semHead, ticks)) return false;
+    ReceiveMany(pQueue, pData, 1);
+    return true;
+}
+
+u32 mosSendManyToQueue(MosQueue * pQueue, const void * pData, u32 count) {
+    // Block for the first slot, then take as many more as are free
+    if (count == 0) return 0;
+    mosWaitForSem(&pQueue->semTail);
+    count = 1 + mosTrySemCount(&pQueue->semTail, count - 1);
+    return SendMany(pQueue, pData, count);
+}
+
+MOS_ISR_SAFE u32 mosTrySendManyToQueue(MosQueue * pQueue, const void * pData, u32 count) {
+    count = mosTrySemCount(&pQueue->semTail, count);
+    if (count == 0) return 0;
+    return SendMany(pQueue, pData, count);
+}
+
+u32 mosSendManyToQueueOrTO(MosQueue * pQueue, const void * pData, u32 count, u32 ticks) {
+    if (count == 0 || !mosWaitForSemOrTO(&pQueue->semTail, ticks)) return 0;
+    count = 1 + mosTrySemCount(&pQueue->semTail, count - 1);
+    return SendMany(pQueue, pData, count);
+}
+
+u32 mosReceiveManyFromQueue(MosQueue * pQueue, void * pData, u32 count) {
+    if (count == 0) return 0;
+    mosWaitForSem(&pQueue->semHead);
+    count = 1 + mosTrySemCount(&pQueue->semHead, count - 1);
+    return ReceiveMany(pQueue, pData, count);
+}
+
+MOS_ISR_SAFE u32 mosTryReceiveManyFromQueue(MosQueue * pQueue, void * pData, u32 count) {
+    count = mosTrySemCount(&pQueue->semHead, count);
+    if (count == 0) return 0;
+    return ReceiveMany(pQueue, pData, count);
+}
+
+u32 mosReceiveManyFromQueueOrTO(MosQueue * pQueue, void * pData, u32 count, u32 ticks) {
+    if (count == 0 || !mosWaitForSemOrTO(&pQueue->semHead, ticks)) return 0;
+    count = 1 + mosTrySemCount(&pQueue->semHead, count - 1);
+    return ReceiveMany(pQueue, pData, count);
+}
+
+//
+// Priority Queues
+//
+//   Each priority has a list of pending messages, and a bitmap of non-empty
+//   lists locates the highest priority message.  Elements are detached from
+//   the lists while being copied, so only list manipulation is performed
+//   with interrupts disabled.
+//
+
+typedef struct PriQueueElm {
+    MosLink link;
+    u32     data[];
+} PriQueueElm;
+
+void mosInitPriQueue(MosPriQueue * pQueue, void * pBuffer, u32 elmSize, u32 numElm, u32 numPri) {
+    mosAssert((elmSize & 0x3) == 0x0);
+    mosAssert(numPri > 0 && numPri <= 32);
+    pQueue->elmSize   = elmSize >> 2;
+    pQueue->numPri    = numPri;
+    pQueue->priMap    = 0;
+    pQueue->pPriLists = (MosList *)pBuffer;
+    for (u32 pri = 0; pri < numPri; pri++) mosInitList(&pQueue->pPriLists[pri]);
+    mosInitList(&pQueue->freeList);
+    u8 * pElm = (u8 *)&pQueue->pPriLists[numPri];
+    for (u32 ix = 0; ix < numElm; ix++) {
+        mosAddToEndOfList(&pQueue->freeList, &((PriQueueElm *)pElm)->link);
+        pElm += sizeof(PriQueueElm) + elmSize;
     }
-    return false;
+    mosInitSem(&pQueue->semFree, numElm);
+    mosInitSem(&pQueue->semMsg, 0);
+}
+
+MOS_ISR_SAFE static void PutToPriQueue(MosPriQueue * pQueue, const u32 * pData, u32 pri) {
+    mosAssert(pri < pQueue->numPri);
+    u32 mask = mosDisableInterrupts();
+    PriQueueElm * pElm = container_of(pQueue->freeList.pNext, PriQueueElm, link);
+    mosRemoveFromList(&pElm->link);
+    mosEnableInterrupts(mask);
+    CopySlot(pElm->data, pData, pQueue->elmSize);
+    asm volatile ( "dmb" );
+    mask = mosDisableInterrupts();
+    mosAddToEndOfList(&pQueue->pPriLists[pri], &pElm->link);
+    pQueue->priMap |= (1u << pri);
+    mosEnableInterrupts(mask);
+    mosIncrementSem(&pQueue->semMsg);
+}
+
+MOS_ISR_SAFE static void GetFromPriQueue(MosPriQueue * pQueue, u32 * pData, u32 * pPri) {
+    u32 mask = mosDisableInterrupts();
+    u32 pri = mosFindFirstSet(pQueue->priMap);
+    MosList * pList = &pQueue->pPriLists[pri];
+    PriQueueElm * pElm = container_of(pList->pNext, PriQueueElm, link);
+    mosRemoveFromList(&pElm->link);
+    if (mosIsListEmpty(pList)) pQueue->priMap &= ~(1u << pri);
+    mosEnableInterrupts(mask);
+    asm volatile ( "dmb" );
+    CopySlot(pData, pElm->data, pQueue->elmSize);
+    mask = mosDisableInterrupts();
+    mosAddToFrontOfList(&pQueue->freeList, &pElm->link);
+    mosEnableInterrupts(mask);
+    mosIncrementSem(&pQueue->semFree);
+    if (pPri) *pPri = pri;
+}
+
+void mosSendToPriQueue(MosPriQueue * pQueue, const void * pData, u32 pri) {
+    mosWaitForSem(&pQueue->semFree);
+    PutToPriQueue(pQueue, pData, pri);
+}
+
+MOS_ISR_SAFE bool mosTrySendToPriQueue(MosPriQueue * pQueue, const void * pData, u32 pri) {
+    if (!mosTrySem(&pQueue->semFree)) return false;
+    PutToPriQueue(pQueue, pData, pri);
+    return true;
+}
+
+bool mosSendToPriQueueOrTO(MosPriQueue * pQueue, const void * pData, u32 pri, u32 ticks) {
+    if (!mosWaitForSemOrTO(&pQueue->semFree, ticks)) return false;
+    PutToPriQueue(pQueue, pData, pri);
+    return true;
+}
+
+void mosReceiveFromPriQueue(MosPriQueue * pQueue, void * pData, u32 * pPri) {
+    mosWaitForSem(&pQueue->semMsg);
+    GetFromPriQueue(pQueue, pData, pPri);
+}
+
+MOS_ISR_SAFE bool mosTryReceiveFromPriQueue(MosPriQueue * pQueue, void * pData, u32 * pPri) {
+    if (!mosTrySem(&pQueue->semMsg)) return false;
+    GetFromPriQueue(pQueue, pData, pPri);
+    return true;
+}
+
+bool mosReceiveFromPriQueueOrTO(MosPriQueue * pQueue, void * pData, u32 * pPri, u32 ticks) {
+    if (!mosWaitForSemOrTO(&pQueue->semMsg, ticks)) return false;
+    GetFromPriQueue(pQueue, pData, pPri);
+    return true;
 }
 
 s16 mosWaitOnMultiQueue(MosSignal * pSignal, u32 * pFlags) {
@@ -87,6 +87,10 @@ MosCommandResult mosGetNextCommand(char * prompt, char * cmd, u32 max_cmd_len) {
     };
     static u32 buf_ix = 0;
     static bool last_ch_was_arrow = false;
+    // Characters are drained from the queue in batches, leftovers are
+    //   kept for the next command.
+    static u32 rx_buf[8];
+    static u32 rx_ix = 0, rx_cnt = 0;
     mosLockTraceMutex();
     if (buf_ix) {
         for (u32 ix = 0; ix < buf_ix; ix++) _mosPrint("\b \b");
@@ -98,7 +102,11 @@ MosCommandResult mosGetNextCommand(char * prompt, char * cmd, u32 max_cmd_len) {
     last_ch_was_arrow = false;
     u32 state = KEY_NORMAL;
     while (1) {
-        char ch = (char) mosReceiveFromQueue32(&RxQueue);
+        if (rx_ix == rx_cnt) {
+            rx_cnt = mosReceiveManyFromQueue(&RxQueue, rx_buf, count_of(rx_buf));
+            rx_ix = 0;
+        }
+        char ch = (char) rx_buf[rx_ix++];
         switch (state) {
         default:
         case KEY_NORMAL:
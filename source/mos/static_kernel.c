@@ -25,7 +25,8 @@
 // Element types for polymorphic lists
 enum {
     ELM_THREAD,
-    ELM_TIMER
+    ELM_TIMER,
+    ELM_DEFERRED_TIMER
 };
 
 typedef struct {
@@ -50,9 +51,17 @@ typedef enum {
     THREAD_WAIT_FOR_MUTEX,
     THREAD_WAIT_FOR_SEM,
     THREAD_WAIT_FOR_STOP,
-    THREAD_WAIT_FOR_TICK         = THREAD_STATE_BASE + THREAD_STATE_TICK,
-    THREAD_WAIT_FOR_SEM_OR_TICK  = THREAD_WAIT_FOR_SEM + THREAD_STATE_TICK,
-    THREAD_WAIT_FOR_STOP_OR_TICK = THREAD_WAIT_FOR_STOP + THREAD_STATE_TICK,
+    THREAD_WAIT_FOR_NOTIFY,
+    THREAD_WAIT_FOR_EVENT_GROUP,
+    THREAD_WAIT_FOR_RWLOCK,
+    THREAD_WAIT_FOR_CONDVAR,
+    THREAD_WAIT_FOR_TICK           = THREAD_STATE_BASE + THREAD_STATE_TICK,
+    THREAD_WAIT_FOR_SEM_OR_TICK    = THREAD_WAIT_FOR_SEM + THREAD_STATE_TICK,
+    THREAD_WAIT_FOR_STOP_OR_TICK   = THREAD_WAIT_FOR_STOP + THREAD_STATE_TICK,
+    THREAD_WAIT_FOR_NOTIFY_OR_TICK = THREAD_WAIT_FOR_NOTIFY + THREAD_STATE_TICK,
+    THREAD_WAIT_FOR_EVENT_GROUP_OR_TICK = THREAD_WAIT_FOR_EVENT_GROUP + THREAD_STATE_TICK,
+    THREAD_WAIT_FOR_RWLOCK_OR_TICK = THREAD_WAIT_FOR_RWLOCK + THREAD_STATE_TICK,
+    THREAD_WAIT_FOR_CONDVAR_OR_TICK = THREAD_WAIT_FOR_CONDVAR + THREAD_STATE_TICK,
 } ThreadState;
 
 typedef struct Thread {
@@ -63,12 +72,30 @@ typedef struct Thread {
     MosLink             runLink;
     MosPmLink           tmrLink;
     MosList             stopQ;
+    MosWaitSetMember  * pStopMember;
+    MosList             mtxQ;
     u32                 wakeTick;
     void              * pBlockedOn;
+    MosPendQ          * pPendQ;
     MosThreadPriority   pri;
     MosThreadPriority   nomPri;
     u8                  timedOut;
-    u8                  pad;
+    u8                  notifyPend;
+    u16                 sliceLeft;
+    MosThreadPriority   threshold;
+    u8                  preemptHeld;
+    MosThreadPriority   pendPri;
+    u8                  deadlineState;
+    u8                  pad[2];
+    u32                 notifyValue;
+    u32                 evtMask;
+    u32                 evtOpts;      // Event group options or rwlock access
+    u32                 deadline;
+    u32                 heapIdx;
+    u32                 budget;
+    u32                 budgetPeriod;
+    s32                 budgetLeft;
+    u32                 replenishTick;
     s32                 rtnVal;
     MosThreadEntry    * pTermHandler;
     s32                 termArg;
@@ -106,7 +133,25 @@ static Thread * pRunningThread = NO_SUCH_THREAD;
 static error_t * pErrNo;
 static Thread IdleThread;
 static MosList RunQueues[MOS_MAX_THREAD_PRIORITIES];
-static MosList ISREventQueue;
+static u16 TimeSlices[MOS_MAX_THREAD_PRIORITIES];
+#if (MOS_ENABLE_EDF == true)
+MOS_STATIC_ASSERT(edf_priority, MOS_EDF_PRIORITY < MOS_MAX_THREAD_PRIORITIES);
+static Thread * EdfHeap[MOS_EDF_MAX_THREADS + 1];  // 1-based binary min-heap
+static u32 EdfHeapSize;
+static u32 DeadlineMisses;
+#define IS_EDF_PRI(pri)   ((pri) == MOS_EDF_PRIORITY)
+#else
+#define IS_EDF_PRI(pri)   false
+#endif
+// Threads have no deadline until one is set, then a miss is reported once
+enum {
+    DEADLINE_NONE,
+    DEADLINE_PENDING,
+    DEADLINE_MISSED,
+};
+static u32 AvoidedContextSwitches;
+static u32 MaxISREventBatch;
+static u32 MaxISREventLockCycles;
 static u32 ExcReturnInitial = MOS_EXC_RETURN_DEFAULT;
 #if (MOS_ARM_RTOS_ON_NON_SECURE_SIDE == true)
 MOS_STATIC_ASSERT(num_sec_contexts, MOS_NUM_SECURE_CONTEXTS <= 32);
@@ -114,8 +159,77 @@ static u32 SecureContextReservation = (1 << MOS_NUM_SECURE_CONTEXTS) - 1;
 static MosSem SecureContextCounter;
 #endif
 
+// Run queue bitmap
+//   A set bit indicates that the run queue at that priority is not empty.
+//   More than 32 priorities requires a second level (one bit per map word).
+#define RUN_QUEUE_MAP_WORDS  ((MOS_MAX_THREAD_PRIORITIES + 31) / 32)
+MOS_STATIC_ASSERT(max_thread_priorities, MOS_MAX_THREAD_PRIORITIES < 256);
+#if (MOS_PEND_QUEUE_BUCKETS == true)
+MOS_STATIC_ASSERT(pend_queue_buckets, MOS_MAX_THREAD_PRIORITIES <= 32);
+#endif
+static u32 RunQueueMap[RUN_QUEUE_MAP_WORDS];
+#if (RUN_QUEUE_MAP_WORDS > 1)
+static u32 RunQueueGroupMap;
+#endif
+
+// ISR events
+//   ISRs post kernel objects to a queue per event type rather than manipulating
+//   run queues directly. The scheduler drains each queue as a batch, passing
+//   every element to the handler of its type. A set bit in the map indicates
+//   that the queue of that type is not empty.
+typedef enum {
+    ISR_EVT_SEM,           // MosSem given (evtLink)
+    ISR_EVT_EVENT_GROUP,   // MosEventGroup flags set (evtLink)
+    ISR_EVT_NOTIFY,        // Thread notified (runLink)
+    ISR_EVT_CALLBACK,      // MosISREvent posted (evtLink)
+    ISR_EVT_TYPES
+} ISREventType;
+
+// Queues and timers have no event types of their own:
+//   An ISR queue send is mosTrySem() and mosIncrementSem() around a copy,
+//   each a constant-time critical section. The semaphore event is posted only
+//   if a reader waits, once per scheduler pass however many messages are sent,
+//   and releases a reader per message. A queue event would need the same link
+//   and do the same work in its handler.
+//   Timers expire in SysTick, which runs at PendSV priority and so already
+//   updates run queues directly with the scheduler locked. Deferred timers are
+//   handed off by one notification per tick however many expire.
+
+static MosList ISREventQueues[ISR_EVT_TYPES];
+static u32 ISREventMap;
+
 // Timers and Ticks
-static MosList TimerQueue;
+//   Timers (threads with timeouts and MosTimers) are kept on a hierarchical
+//   timing wheel. Each level has TIMER_WHEEL_SLOTS slots with a bitmap of
+//   non-empty slots. Slots on level 0 span one tick, slots on each higher
+//   level span all of the level below. Timers further out than the top level
+//   are kept on an (unsorted) overflow queue. Entries on higher levels are
+//   cascaded down when the lower level wraps, so inserts are O(1).
+//   The wheel costs TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOTS list heads.
+#define TIMER_WHEEL_BITS     5
+#define TIMER_WHEEL_SLOTS    (1 << TIMER_WHEEL_BITS)
+#define TIMER_WHEEL_MASK     (TIMER_WHEEL_SLOTS - 1)
+#define TIMER_WHEEL_LEVELS   MOS_TIMER_WHEEL_LEVELS
+MOS_STATIC_ASSERT(timer_wheel_levels, TIMER_WHEEL_LEVELS >= 1 &&
+                  TIMER_WHEEL_LEVELS * TIMER_WHEEL_BITS <= 30);
+static MosList TimerWheel[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS];
+static u32 TimerWheelMap[TIMER_WHEEL_LEVELS];
+static MosList TimerOverflowQueue;
+static u32 TimerTick;  // Next tick to be processed by timer wheel
+static u32 MaxTickCycles;
+static bool Relinquish;  // Running thread voluntarily yields despite threshold
+// Runnable threads holding a preemption threshold, most recently run last.
+//   Each entry preempted those before it, so nesting is bounded by priority.
+static Thread * ThresholdOwners[MOS_MAX_THREAD_PRIORITIES];
+static u32 ThresholdOwnerCnt;
+#if (MOS_ENABLE_CPU_BUDGETS == true)
+static u32 ChargeCycles;  // Cycle count when running thread was last charged
+#endif
+#if (MOS_ENABLE_DEFERRED_TIMERS == true)
+static MosList DeferredTimerQueue;
+static Thread TimerThread;
+static u8 MOS_STACK_ALIGNED TimerStack[MOS_TIMER_THREAD_STACK_SIZE];
+#endif
 static volatile Ticker MOS_ALIGNED(8) Tick = { .count = 1 };
 static s32 MaxTickInterval;
 static u32 CyclesPerTick;
@@ -152,6 +266,26 @@ MOS_ISR_SAFE static MOS_INLINE void YieldThread(void) {
     asm volatile ( "dsb" );
 }
 
+// Queue element on ISR event queue of type, interrupts must be disabled
+MOS_ISR_SAFE static MOS_INLINE void PostISREvent(ISREventType type, MosLink * pElm) {
+    mosAddToEndOfList(&ISREventQueues[type], pElm);
+    ISREventMap |= (1 << type);
+}
+
+typedef enum {
+    WAIT_SET_SEM,
+    WAIT_SET_THREAD,
+    WAIT_SET_TIMER,
+} WaitSetMemberType;
+
+// Queue member on ready queue of its wait set unless already queued,
+//   interrupts must be disabled
+MOS_ISR_SAFE static void QueueWaitSetMember(MosWaitSetMember * pMember) {
+    if (pMember->pSet == NULL || mosIsOnList(&pMember->readyLink)) return;
+    mosAddToEndOfList(&pMember->pSet->readyQ, &pMember->readyLink);
+    mosIncrementSem(&pMember->pSet->sem);
+}
+
 static MOS_INLINE void SetRunningThreadStateAndYield(ThreadState state) {
     asm volatile ( "dmb" );
     LockScheduler(IntPriMaskLow);
@@ -160,6 +294,280 @@ static MOS_INLINE void SetRunningThreadStateAndYield(ThreadState state) {
     UnlockScheduler();
 }
 
+//
+// Run Queues
+//
+
+#if (MOS_ARCH_CAT == MOS_ARCH_ARM_CORTEX_M_BASE)
+
+// Baseline has no CLZ instruction, use a de Bruijn sequence lookup instead
+static const u8 DeBruijnBitPosition[32] = {
+     0,  1, 28,  2, 29, 14, 24,  3, 30, 22, 20, 15, 25, 17,  4,  8,
+    31, 27, 13, 23, 21, 19, 16,  7, 26, 12, 18,  6, 11,  5, 10,  9
+};
+
+// Obtain index of least significant set bit (map must be non-zero)
+static MOS_INLINE u32 FindFirstSet(u32 map) {
+    return DeBruijnBitPosition[((map & -map) * 0x077cb531) >> 27];
+}
+
+// Obtain index of most significant set bit (map must be non-zero)
+static MOS_INLINE u32 FindLastSet(u32 map) {
+    map |= map >> 1;
+    map |= map >> 2;
+    map |= map >> 4;
+    map |= map >> 8;
+    map |= map >> 16;
+    return FindFirstSet(map ^ (map >> 1));
+}
+
+#else
+
+// Obtain index of least significant set bit (map must be non-zero)
+static MOS_INLINE u32 FindFirstSet(u32 map) {
+    return __builtin_ctz(map);
+}
+
+// Obtain index of most significant set bit (map must be non-zero)
+static MOS_INLINE u32 FindLastSet(u32 map) {
+    return 31 - __builtin_clz(map);
+}
+
+#endif
+
+MOS_ISR_SAFE u32 mosFindFirstSet(u32 map) {
+    return FindFirstSet(map);
+}
+
+// Return highest priority with a non-empty run queue,
+//   or MOS_MAX_THREAD_PRIORITIES (the idle priority) if there is none.
+static MOS_INLINE MosThreadPriority GetTopRunQueue(void) {
+#if (RUN_QUEUE_MAP_WORDS > 1)
+    if (RunQueueGroupMap == 0) return MOS_MAX_THREAD_PRIORITIES;
+    u32 word = FindFirstSet(RunQueueGroupMap);
+    return (word << 5) + FindFirstSet(RunQueueMap[word]);
+#else
+    if (RunQueueMap[0] == 0) return MOS_MAX_THREAD_PRIORITIES;
+    return FindFirstSet(RunQueueMap[0]);
+#endif
+}
+
+static MOS_INLINE void MarkRunQueue(MosThreadPriority pri) {
+    RunQueueMap[pri >> 5] |= (1u << (pri & 31));
+#if (RUN_QUEUE_MAP_WORDS > 1)
+    RunQueueGroupMap |= (1u << (pri >> 5));
+#endif
+}
+
+static MOS_INLINE void UnmarkRunQueue(MosThreadPriority pri) {
+    RunQueueMap[pri >> 5] &= ~(1u << (pri & 31));
+#if (RUN_QUEUE_MAP_WORDS > 1)
+    if (RunQueueMap[pri >> 5] == 0) RunQueueGroupMap &= ~(1u << (pri >> 5));
+#endif
+}
+
+#if (MOS_ENABLE_EDF == true)
+
+// EDF band keeps its runnable threads in a deadline heap instead of a
+//   run queue list. Threads in the heap record their (1-based) heap index.
+//   Threads without a deadline rank after all threads with one.
+
+MOS_ISR_SAFE static MOS_INLINE bool EarlierDeadline(Thread * pThd1, Thread * pThd2) {
+    if (pThd1->deadlineState == DEADLINE_NONE) return false;
+    if (pThd2->deadlineState == DEADLINE_NONE) return true;
+    return (s32)(pThd1->deadline - pThd2->deadline) < 0;
+}
+
+// Report miss once per deadline of thread in the EDF band
+static void CheckDeadline(Thread * pThd) {
+    if (pThd->deadlineState == DEADLINE_PENDING && IS_EDF_PRI(pThd->pri) &&
+            (s32)(Tick.lower - pThd->deadline) > 0) {
+        pThd->deadlineState = DEADLINE_MISSED;
+        DeadlineMisses++;
+        EVENT(DEADLINE_MISS, (u32)pThd);
+    }
+}
+
+static MOS_INLINE void SetEdfHeapEntry(u32 idx, Thread * pThd) {
+    EdfHeap[idx] = pThd;
+    pThd->heapIdx = idx;
+}
+
+static void SiftUpEdfHeap(u32 idx) {
+    Thread * pThd = EdfHeap[idx];
+    while (idx > 1 && EarlierDeadline(pThd, EdfHeap[idx >> 1])) {
+        SetEdfHeapEntry(idx, EdfHeap[idx >> 1]);
+        idx >>= 1;
+    }
+    SetEdfHeapEntry(idx, pThd);
+}
+
+static void SiftDownEdfHeap(u32 idx) {
+    Thread * pThd = EdfHeap[idx];
+    while (1) {
+        u32 child = idx << 1;
+        if (child > EdfHeapSize) break;
+        if (child < EdfHeapSize && EarlierDeadline(EdfHeap[child + 1], EdfHeap[child]))
+            child++;
+        if (!EarlierDeadline(EdfHeap[child], pThd)) break;
+        SetEdfHeapEntry(idx, EdfHeap[child]);
+        idx = child;
+    }
+    SetEdfHeapEntry(idx, pThd);
+}
+
+static void AddThreadToEdfHeap(Thread * pThd) {
+    mosAssert(EdfHeapSize < MOS_EDF_MAX_THREADS);
+    EdfHeap[++EdfHeapSize] = pThd;
+    SiftUpEdfHeap(EdfHeapSize);
+    MarkRunQueue(MOS_EDF_PRIORITY);
+}
+
+// Threads leaving the heap (blocking, stopping or changing deadline) are
+//   checked for a miss, as they are no longer checked on each tick.
+static void RemoveThreadFromEdfHeap(Thread * pThd) {
+    u32 idx = pThd->heapIdx;
+    CheckDeadline(pThd);
+    Thread * pLast = EdfHeap[EdfHeapSize--];
+    pThd->heapIdx = 0;
+    if (pLast != pThd) {
+        EdfHeap[idx] = pLast;
+        SiftUpEdfHeap(idx);
+        SiftDownEdfHeap(pLast->heapIdx);
+    }
+    if (EdfHeapSize == 0) UnmarkRunQueue(MOS_EDF_PRIORITY);
+}
+
+// Check deadlines of runnable threads in the EDF band. Deadlines never
+//   decrease toward the leaves, so only subtrees whose root has passed
+//   its deadline are searched.
+static void CheckEdfDeadlines(void) {
+    u32 stack[MOS_EDF_MAX_THREADS];
+    u32 top = 0;
+    if (EdfHeapSize) stack[top++] = 1;
+    while (top) {
+        u32 idx = stack[--top];
+        Thread * pThd = EdfHeap[idx];
+        if (pThd->deadlineState == DEADLINE_NONE ||
+                (s32)(Tick.lower - pThd->deadline) <= 0) continue;
+        CheckDeadline(pThd);
+        if ((idx << 1) <= EdfHeapSize) stack[top++] = idx << 1;
+        if ((idx << 1) + 1 <= EdfHeapSize) stack[top++] = (idx << 1) + 1;
+    }
+}
+
+#endif
+
+// Threads at priorities below the running thread preemption threshold
+//   (or its priority if that is higher) may not preempt it. Within the EDF
+//   band an earlier deadline preempts. Flags held off preemption so it may
+//   be performed when the threshold is lowered.
+MOS_ISR_SAFE static MOS_INLINE bool PreemptsRunningThread(Thread * pThd) {
+    MosThreadPriority pri = pThd->pri;
+    MosThreadPriority thr = pRunningThread->threshold;
+    if (pRunningThread->pri < thr) thr = pRunningThread->pri;
+    if (pri < thr) return true;
+#if (MOS_ENABLE_EDF == true)
+    if (IS_EDF_PRI(pri) && pri == thr && pri == pRunningThread->pri &&
+            EarlierDeadline(pThd, pRunningThread)) return true;
+#endif
+    if (pri < pRunningThread->pri) pRunningThread->preemptHeld = 1;
+    return false;
+}
+
+static void RemoveThresholdOwner(Thread * pThd) {
+    u32 cnt = 0;
+    for (u32 ix = 0; ix < ThresholdOwnerCnt; ix++) {
+        if (ThresholdOwners[ix] != pThd) ThresholdOwners[cnt++] = ThresholdOwners[ix];
+    }
+    ThresholdOwnerCnt = cnt;
+}
+
+// Drop threshold owners that blocked, stopped or released their threshold,
+//   returning the most recently run owner that remains.
+static Thread * GetThresholdOwner(void) {
+    u32 cnt = 0;
+    for (u32 ix = 0; ix < ThresholdOwnerCnt; ix++) {
+        Thread * pThd = ThresholdOwners[ix];
+        if (pThd->state == THREAD_RUNNABLE && pThd->threshold < pThd->pri)
+            ThresholdOwners[cnt++] = pThd;
+    }
+    ThresholdOwnerCnt = cnt;
+    return cnt ? ThresholdOwners[cnt - 1] : NO_SUCH_THREAD;
+}
+
+// Run queue manipulation keeps the bitmap in sync with the run queues.
+//   Threads receive a fresh time slice whenever they are (re)queued.
+//   NOTE: Must lock scheduler (or disable interrupts) before calling.
+static MOS_INLINE void AddThreadToRunQueue(Thread * pThd) {
+#if (MOS_ENABLE_EDF == true)
+    if (IS_EDF_PRI(pThd->pri)) {
+        AddThreadToEdfHeap(pThd);
+        return;
+    }
+#endif
+    mosAddToEndOfList(&RunQueues[pThd->pri], &pThd->runLink);
+    MarkRunQueue(pThd->pri);
+    pThd->sliceLeft = TimeSlices[pThd->pri];
+}
+
+static MOS_INLINE void AddThreadToFrontOfRunQueue(Thread * pThd) {
+#if (MOS_ENABLE_EDF == true)
+    if (IS_EDF_PRI(pThd->pri)) {
+        AddThreadToEdfHeap(pThd);
+        return;
+    }
+#endif
+    mosAddToFrontOfList(&RunQueues[pThd->pri], &pThd->runLink);
+    MarkRunQueue(pThd->pri);
+    pThd->sliceLeft = TimeSlices[pThd->pri];
+}
+
+//
+// Pend Queues
+//
+
+static void InitPendQ(MosPendQ * pPendQ) {
+    mosInitList(&pPendQ->list);
+#if (MOS_PEND_QUEUE_BUCKETS == true)
+    pPendQ->map = 0;
+#endif
+}
+
+// Remove thread from pend queue (or any other list it is on).
+//   Bucketed pend queues hand the tail of the thread priority bucket to
+//   the previous thread if it has the same priority, or empty the bucket.
+MOS_ISR_SAFE static MOS_INLINE void RemoveThreadFromPendQ(Thread * pThd) {
+#if (MOS_PEND_QUEUE_BUCKETS == true)
+    MosPendQ * pPendQ = pThd->pPendQ;
+    if (pPendQ) {
+        MosThreadPriority pri = pThd->pendPri;
+        if (pPendQ->pTail[pri] == &pThd->runLink) {
+            MosLink * pPrev = pThd->runLink.pPrev;
+            if (pPrev != &pPendQ->list && container_of(pPrev, Thread, runLink)->pendPri == pri)
+                pPendQ->pTail[pri] = pPrev;
+            else pPendQ->map &= ~(1u << pri);
+        }
+        pThd->pPendQ = NULL;
+    }
+#endif
+    mosRemoveFromList(&pThd->runLink);
+}
+
+// Remove thread from its run queue (or any other list it is on).
+//   Thread priority must match the run queue it was added to.
+static MOS_INLINE void RemoveThreadFromList(Thread * pThd) {
+#if (MOS_ENABLE_EDF == true)
+    if (pThd->heapIdx) {
+        RemoveThreadFromEdfHeap(pThd);
+        return;
+    }
+#endif
+    RemoveThreadFromPendQ(pThd);
+    if (!IS_EDF_PRI(pThd->pri) && mosIsListEmpty(&RunQueues[pThd->pri]))
+        UnmarkRunQueue(pThd->pri);
+}
+
 static void KPrintf(const char * pFmt, ...) {
     if (VPrintfHook) {
         va_list args;
@@ -246,28 +654,216 @@ MOS_ISR_SAFE void MOS_NAKED mosDelayMicroseconds(u32 usec) {
     );
 }
 
+MOS_ISR_SAFE static MOS_INLINE u32 RotateRight(u32 val, u32 shift) {
+    return (val >> shift) | (val << ((32 - shift) & 31));
+}
+
+// Move all elements of list to another (uninitialized) list
+static void TakeList(MosList * pDst, MosList * pSrc) {
+    if (mosIsListEmpty(pSrc)) {
+        mosInitList(pDst);
+    } else {
+        pDst->pNext = pSrc->pNext;
+        pDst->pPrev = pSrc->pPrev;
+        pDst->pNext->pPrev = pDst;
+        pDst->pPrev->pNext = pDst;
+        mosInitList(pSrc);
+    }
+}
+
+static u32 GetWakeTick(MosPmLink * pLink) {
+    if (pLink->type == ELM_THREAD)
+        return container_of(pLink, Thread, tmrLink)->wakeTick;
+    else
+        return container_of(pLink, MosTimer, tmrLink)->wakeTick;
+}
+
+// Place timer on the wheel level and slot matching its distance from TimerTick.
+//   Expired timers are placed in the slot processed on the next tick.
+//   NOTE: Must lock scheduler before calling
+static void AddToTimerWheel(MosPmLink * pLink, u32 wakeTick) {
+    s32 delta = (s32)(wakeTick - TimerTick);
+    if (delta < 0) {
+        delta = 0;
+        wakeTick = TimerTick;
+    }
+    for (u32 level = 0; level < TIMER_WHEEL_LEVELS; level++) {
+        if (((u32)delta >> ((level + 1) * TIMER_WHEEL_BITS)) == 0) {
+            u32 slot = (wakeTick >> (level * TIMER_WHEEL_BITS)) & TIMER_WHEEL_MASK;
+            mosAddToEndOfList(&TimerWheel[level][slot], &pLink->link);
+            TimerWheelMap[level] |= (1u << slot);
+            return;
+        }
+    }
+    mosAddToEndOfList(&TimerOverflowQueue, &pLink->link);
+}
+
+// Redistribute timers from a higher level slot (or overflow queue) to lower levels
+static void CascadeTimers(MosList * pList) {
+    MosList list;
+    TakeList(&list, pList);
+    while (!mosIsListEmpty(&list)) {
+        MosPmLink * pLink = (MosPmLink *)list.pNext;
+        mosRemoveFromList(&pLink->link);
+        AddToTimerWheel(pLink, GetWakeTick(pLink));
+    }
+}
+
+// Determine the next tick at which the timer wheel has work to do (expiration
+//   or cascade). Returns false if there are no timers.
+//   NOTE: Interrupts must be disabled or scheduler locked before calling
+static bool GetNextTimerTick(u32 * pTick) {
+    u32 minOffset = 0xffffffff;
+    for (u32 level = 0; level < TIMER_WHEEL_LEVELS; level++) {
+        u32 shift = level * TIMER_WHEEL_BITS;
+        u32 mask = (1 << shift) - 1;
+        // First tick at or after TimerTick when this level is processed
+        u32 base = (TimerTick + mask) & ~mask;
+        u32 curSlot = (base >> shift) & TIMER_WHEEL_MASK;
+        u32 map = TimerWheelMap[level];
+        while (map) {
+            u32 slot = (curSlot + FindFirstSet(RotateRight(map, curSlot))) & TIMER_WHEEL_MASK;
+            if (!mosIsListEmpty(&TimerWheel[level][slot])) {
+                u32 offset = (base - TimerTick) + (((slot - curSlot) & TIMER_WHEEL_MASK) << shift);
+                if (offset < minOffset) minOffset = offset;
+                break;
+            }
+            // Clear bits for slots emptied by cancelled timers
+            map &= ~(1u << slot);
+            TimerWheelMap[level] = map;
+        }
+    }
+    if (!mosIsListEmpty(&TimerOverflowQueue)) {
+        u32 mask = (1 << (TIMER_WHEEL_LEVELS * TIMER_WHEEL_BITS)) - 1;
+        u32 offset = ((TimerTick + mask) & ~mask) - TimerTick;
+        if (offset < minOffset) minOffset = offset;
+    }
+    if (minOffset == 0xffffffff) return false;
+    *pTick = TimerTick + minOffset;
+    return true;
+}
+
+// Process one tick of the timer wheel, cascading higher levels on
+//   boundaries and then expiring the timers in the current level 0 slot.
+//   Returns true if a thread of higher priority than the running thread
+//   was made runnable.
+static bool ProcessTimerTick(void) {
+    bool preempt = false;
+#if (MOS_ENABLE_DEFERRED_TIMERS == true)
+    bool deferred = false;
+#endif
+    u32 tick = TimerTick;
+    if ((tick & ((1 << (TIMER_WHEEL_LEVELS * TIMER_WHEEL_BITS)) - 1)) == 0)
+        CascadeTimers(&TimerOverflowQueue);
+    for (u32 level = TIMER_WHEEL_LEVELS - 1; level > 0; level--) {
+        u32 shift = level * TIMER_WHEEL_BITS;
+        if (tick & ((1 << shift) - 1)) continue;
+        u32 slot = (tick >> shift) & TIMER_WHEEL_MASK;
+        TimerWheelMap[level] &= ~(1u << slot);
+        CascadeTimers(&TimerWheel[level][slot]);
+    }
+    u32 slot = tick & TIMER_WHEEL_MASK;
+    MosList expired;
+    TakeList(&expired, &TimerWheel[0][slot]);
+    TimerWheelMap[0] &= ~(1u << slot);
+    TimerTick = tick + 1;
+    while (!mosIsListEmpty(&expired)) {
+        MosLink * pElm = expired.pNext;
+        mosRemoveFromList(pElm);
+        if (((MosPmLink *)pElm)->type == ELM_THREAD) {
+            Thread * pThd = container_of(pElm, Thread, tmrLink);
+            if (pThd->state == THREAD_WAIT_FOR_SEM_OR_TICK) {
+                _mosDisableInterrupts();
+                if (mosIsOnList(&((MosSem *)pThd->pBlockedOn)->evtLink)) {
+                    // Event occurred before timeout, just let it be processed
+                    _mosEnableInterrupts();
+                    continue;
+                } else {
+                    RemoveThreadFromPendQ(pThd);
+                    _mosEnableInterrupts();
+                }
+            } else if (pThd->state == THREAD_WAIT_FOR_NOTIFY_OR_TICK) {
+                _mosDisableInterrupts();
+                if (mosIsOnList(&pThd->runLink)) {
+                    // Notified before timeout, just let it be processed
+                    _mosEnableInterrupts();
+                    continue;
+                }
+                // Runnable state prevents ISRs from queueing notification
+                SetThreadState(pThd, THREAD_RUNNABLE);
+                _mosEnableInterrupts();
+            } else if (pThd->state == THREAD_WAIT_FOR_EVENT_GROUP_OR_TICK) {
+                // Event group pend queues are read by ISRs setting flags
+                _mosDisableInterrupts();
+                RemoveThreadFromPendQ(pThd);
+                _mosEnableInterrupts();
+            } else RemoveThreadFromPendQ(pThd);
+            AddThreadToRunQueue(pThd);
+            pThd->timedOut = 1;
+            SetThreadState(pThd, THREAD_RUNNABLE);
+            if (PreemptsRunningThread(pThd)) preempt = true;
+        } else if (((MosPmLink *)pElm)->type == ELM_TIMER) {
+            MosTimer * pTmr = container_of(pElm, MosTimer, tmrLink);
+            // Retry on next tick if callback returns false
+            if (!(pTmr->pCallback)(pTmr) && !mosIsOnList(pElm))
+                AddToTimerWheel(&pTmr->tmrLink, pTmr->wakeTick);
+        }
+#if (MOS_ENABLE_DEFERRED_TIMERS == true)
+        else {
+            // Hand off to timer service thread
+            mosAddToEndOfList(&DeferredTimerQueue, pElm);
+            deferred = true;
+        }
+#endif
+    }
+#if (MOS_ENABLE_DEFERRED_TIMERS == true)
+    if (deferred) mosNotifyThread((MosThread *)&TimerThread, 0, MOS_NOTIFY_SET_BITS);
+#endif
+    return preempt;
+}
+
 void mosInitTimer(MosTimer * pTmr, MosTimerCallback * pCallback) {
     mosInitPmLink(&pTmr->tmrLink, ELM_TIMER);
     pTmr->pCallback = pCallback;
+    pTmr->pMember = NULL;
 }
 
-static void AddTimer(MosTimer * pTmr) {
-    // NOTE: Must lock scheduler before calling
-    MosLink * pElm;
-    u32 tickCount = mosGetTickCount();
-    pTmr->wakeTick = tickCount + pTmr->ticks;
-    for (pElm = TimerQueue.pNext; pElm != &TimerQueue; pElm = pElm->pNext) {
-        if (((MosPmLink *)pElm)->type == ELM_THREAD) {
-            Thread * pThd = container_of(pElm, Thread, tmrLink);
-            s32 tmrRemTicks = (s32)pThd->wakeTick - tickCount;
-            if ((s32)pTmr->ticks <= tmrRemTicks) break;
-        } else {
-            MosTimer * pTmrTmr = container_of(pElm, MosTimer, tmrLink);
-            s32 tmrRemTicks = (s32)pTmrTmr->wakeTick - tickCount;
-            if ((s32)pTmr->ticks <= tmrRemTicks) break;
+#if (MOS_ENABLE_DEFERRED_TIMERS == true)
+
+void mosInitDeferredTimer(MosTimer * pTmr, MosTimerCallback * pCallback) {
+    mosInitPmLink(&pTmr->tmrLink, ELM_DEFERRED_TIMER);
+    pTmr->pCallback = pCallback;
+    pTmr->pMember = NULL;
+}
+
+// Timer service thread runs callbacks of expired deferred timers
+static s32 TimerThreadEntry(s32 arg) {
+    MOS_UNUSED(arg);
+    while (1) {
+        mosWaitForNotify(0xffffffff);
+        LockScheduler(IntPriMaskLow);
+        while (!mosIsListEmpty(&DeferredTimerQueue)) {
+            MosLink * pElm = DeferredTimerQueue.pNext;
+            mosRemoveFromList(pElm);
+            MosTimer * pTmr = container_of(pElm, MosTimer, tmrLink);
+            UnlockScheduler();
+            bool done = (pTmr->pCallback)(pTmr);
+            LockScheduler(IntPriMaskLow);
+            // Retry on next tick if callback returns false
+            if (!done && !mosIsOnList(pElm))
+                AddToTimerWheel(&pTmr->tmrLink, pTmr->wakeTick);
         }
+        UnlockScheduler();
     }
-    mosAddToListBefore(pElm, &pTmr->tmrLink.link);
+    return 0;
+}
+
+#endif
+
+static void AddTimer(MosTimer * pTmr) {
+    // NOTE: Must lock scheduler before calling
+    pTmr->wakeTick = mosGetTickCount() + pTmr->ticks;
+    AddToTimerWheel(&pTmr->tmrLink, pTmr->wakeTick);
 }
 
 void mosSetTimer(MosTimer * pTmr, u32 ticks, void * pUser) {
@@ -301,13 +897,106 @@ void mosDelayThread(u32 ticks) {
     if (ticks) {
         SetTimeout(ticks);
         SetRunningThreadStateAndYield(THREAD_WAIT_FOR_TICK);
-    } else YieldThread();
+    } else {
+        // Rotate to back of run queue so same priority threads may run
+        LockScheduler(IntPriMaskLow);
+        if (pRunningThread->state == THREAD_RUNNABLE && !IS_EDF_PRI(pRunningThread->pri)) {
+            mosMoveToEndOfList(&RunQueues[pRunningThread->pri], &pRunningThread->runLink);
+            pRunningThread->sliceLeft = TimeSlices[pRunningThread->pri];
+        }
+        Relinquish = true;
+        UnlockScheduler();
+        YieldThread();
+    }
+}
+
+bool mosDelayUntil(u32 * pLastWake, u32 period) {
+    u32 wakeTick = *pLastWake + period;
+    *pLastWake = wakeTick;
+    s32 ticks = (s32)(wakeTick - Tick.lower);
+    if (ticks < 0) return false;
+    if (ticks > 0) {
+        pRunningThread->wakeTick = wakeTick;
+        SetRunningThreadStateAndYield(THREAD_WAIT_FOR_TICK);
+    }
+    return true;
+}
+
+void mosInitPeriodic(MosPeriodic * pPer, u32 period) {
+    pPer->period = period;
+    pPer->lastRelease = Tick.lower;
+    pPer->releaseCount = 0;
+    pPer->overrunCount = 0;
+    pPer->lastJitter = 0;
+    pPer->maxJitter = 0;
+}
+
+#if (MOS_ENABLE_EDF == true)
+
+// Update deadline, reordering the EDF heap if thread is runnable.
+//   A miss of the previous deadline is reported if not already.
+static void SetThreadDeadline(Thread * pThd, u32 deadline) {
+    LockScheduler(IntPriMaskLow);
+    if (pThd->heapIdx) {
+        RemoveThreadFromEdfHeap(pThd);
+        pThd->deadline = deadline;
+        pThd->deadlineState = DEADLINE_PENDING;
+        AddThreadToEdfHeap(pThd);
+        // Might no longer be the earliest deadline
+        if (pThd == pRunningThread && EdfHeap[1] != pThd) YieldThread();
+    } else {
+        CheckDeadline(pThd);
+        pThd->deadline = deadline;
+        pThd->deadlineState = DEADLINE_PENDING;
+    }
+    UnlockScheduler();
+}
+
+void mosSetThreadDeadline(MosThread * pThd, u32 deadline) {
+    SetThreadDeadline((Thread *)pThd, deadline);
+}
+
+MOS_ISR_SAFE u32 mosGetDeadlineMissCount(void) {
+    return DeadlineMisses;
+}
+
+#endif
+
+bool mosWaitForNextPeriod(MosPeriodic * pPer) {
+#if (MOS_ENABLE_EDF == true)
+    // Deadline of next release is the release following it
+    if (IS_EDF_PRI(pRunningThread->pri))
+        SetThreadDeadline(pRunningThread, pPer->lastRelease + 2 * pPer->period);
+#endif
+    bool onTime = mosDelayUntil(&pPer->lastRelease, pPer->period);
+    // Release jitter is measured from the start of the release tick
+    u32 mask = mosDisableInterrupts();
+    u64 cycles = mosGetCycleCount();
+    s64 count = Tick.count;
+    mosEnableInterrupts(mask);
+    s64 releaseCount = count - (u32)((u32)count - pPer->lastRelease);
+    u32 jitter = (u32)(cycles - (u64)(releaseCount - 1) * CyclesPerTick);
+    if (!onTime) {
+        pPer->overrunCount++;
+        pPer->lastRelease = (u32)count;
+#if (MOS_ENABLE_EDF == true)
+        if (IS_EDF_PRI(pRunningThread->pri))
+            SetThreadDeadline(pRunningThread, pPer->lastRelease + pPer->period);
+#endif
+    }
+    pPer->releaseCount++;
+    pPer->lastJitter = jitter;
+    if (jitter > pPer->maxJitter) pPer->maxJitter = jitter;
+    return onTime;
 }
 
+static void ReleaseRwLockHolds(Thread * pThd);
+
 // ThreadExit is invoked when a thread stops (returns from its natural entry point)
 //   or after its termination handler returns (kill or exception)
 static s32 ThreadExit(s32 rtnVal) {
     LockScheduler(IntPriMaskLow);
+    ReleaseRwLockHolds(pRunningThread);
     pRunningThread->rtnVal = rtnVal;
     SetThreadState(pRunningThread, THREAD_STOPPED);
     asm volatile ( "dmb" );
@@ -319,12 +1008,17 @@ static s32 ThreadExit(s32 rtnVal) {
         pElmSave = pElm->pNext;
         Thread * thd = container_of(pElm, Thread, runLink);
         mosRemoveFromList(pElm);
-        mosAddToEndOfList(&RunQueues[thd->pri], &thd->runLink);
+        AddThreadToRunQueue(thd);
         if (mosIsOnList(&thd->tmrLink.link))
             mosRemoveFromList(&thd->tmrLink.link);
         SetThreadState(thd, THREAD_RUNNABLE);
     }
-    mosRemoveFromList(&pRunningThread->runLink);
+    if (pRunningThread->pStopMember) {
+        u32 mask = mosDisableInterrupts();
+        QueueWaitSetMember(pRunningThread->pStopMember);
+        mosEnableInterrupts(mask);
+    }
+    RemoveThreadFromList(pRunningThread);
     YieldThread();
     UnlockScheduler();
     // Not reachable
@@ -364,6 +1058,16 @@ InitThread(Thread * pThd, MosThreadPriority pri, MosThreadEntry * pEntry, s32 ar
     pThd->pStackBottom = pStackBottom;
     pThd->stackSize = stackSize;
     pThd->pName = "";
+    pThd->notifyValue = 0;
+    pThd->notifyPend = 0;
+    pThd->deadline = 0;
+    pThd->deadlineState = DEADLINE_NONE;
+    pThd->heapIdx = 0;
+    pThd->budget = 0;
+    pThd->threshold = MOS_NO_PREEMPT_THRESHOLD;
+    mosInitList(&pThd->mtxQ);
+    pThd->preemptHeld = 0;
+    pThd->pPendQ = NULL;
 #if (MOS_ARM_RTOS_ON_NON_SECURE_SIDE == true)
     pThd->secureContext    = MOS_DEFAULT_SECURE_CONTEXT;
     pThd->secureContextNew = MOS_DEFAULT_SECURE_CONTEXT;
@@ -382,14 +1086,9 @@ static s32 IdleThreadEntry(s32 arg) {
         if (MOS_REG(TICK_CTRL) & MOS_REG_VALUE(TICK_FLAG)) Tick.count += 1;
         // Figure out how long to wait
         s32 tickInterval = MaxTickInterval;
-        if (!mosIsListEmpty(&TimerQueue)) {
-            if (((MosPmLink *)TimerQueue.pNext)->type == ELM_THREAD) {
-                Thread * thd = container_of(TimerQueue.pNext, Thread, tmrLink);
-                tickInterval = (s32)thd->wakeTick - Tick.lower;
-            } else {
-                MosTimer * tmr = container_of(TimerQueue.pNext, MosTimer, tmrLink);
-                tickInterval = (s32)tmr->wakeTick - Tick.lower;
-            }
+        u32 nextTick;
+        if (GetNextTimerTick(&nextTick)) {
+            tickInterval = (s32)(nextTick - Tick.lower);
             if (tickInterval <= 0) {
                 tickInterval = 1;
             } else if (tickInterval > MaxTickInterval) {
@@ -437,6 +1136,28 @@ MosThread * mosGetRunningThread(void) {
     return (MosThread *)pRunningThread;
 }
 
+MOS_ISR_SAFE u32 mosGetMaxTickCycles(void) {
+    return MaxTickCycles;
+}
+
+MOS_ISR_SAFE void mosResetMaxTickCycles(void) {
+    MaxTickCycles = 0;
+}
+
+MOS_ISR_SAFE u32 mosGetAvoidedContextSwitchCount(void) {
+    return AvoidedContextSwitches;
+}
+
+MOS_ISR_SAFE void mosGetISREventStats(u32 * pMaxBatch, u32 * pMaxLockCycles) {
+    *pMaxBatch = MaxISREventBatch;
+    *pMaxLockCycles = MaxISREventLockCycles;
+}
+
+MOS_ISR_SAFE void mosResetISREventStats(void) {
+    MaxISREventBatch = 0;
+    MaxISREventLockCycles = 0;
+}
+
 void mosGetStackStats(MosThread * _pThd, u32 * pStackSize, u32 * pStackUsage, u32 * pMaxStackUsage) {
     Thread * pThd = (Thread *)_pThd;
     LockScheduler(IntPriMaskLow);
@@ -490,11 +1211,13 @@ bool mosInitThread(MosThread * _pThd, MosThreadPriority pri,
     // Detect uninitialized thread state variable
     if ((pThd->state & THREAD_STATE_BASE_MASK) != THREAD_STATE_BASE)
         pThd->state = THREAD_UNINIT;
+    bool detach = (pThd->state != THREAD_UNINIT);
     // Check thread state
     switch (pThd->state) {
     case THREAD_UNINIT:
     case THREAD_INIT:
         mosInitList(&pThd->stopQ);
+        pThd->pStopMember = NULL;
         // fall through
     case THREAD_STOPPED:
         mosInitList(&pThd->runLink);
@@ -507,11 +1230,26 @@ bool mosInitThread(MosThread * _pThd, MosThreadPriority pri,
         if (mosIsOnList(&pThd->tmrLink.link))
             mosRemoveFromList(&pThd->tmrLink.link);
         // Lock because thread might be on semaphore pend queue
-        _mosDisableInterrupts();
-        mosRemoveFromList(&pThd->runLink);
-        _mosEnableInterrupts();
+        //   or about to be placed on notify queue by an ISR.
+        //   Nestable since the scheduler is locked (BASEPRI).
+        u32 mask = mosDisableInterrupts();
+        // A thread notified but not yet made runnable is still on the
+        //   notify queue, dequeue it and discard the notification.
+        RemoveThreadFromList(pThd);
+        pThd->notifyPend = 0;
+        pThd->notifyValue = 0;
+        SetThreadState(pThd, THREAD_UNINIT);
+        mosEnableInterrupts(mask);
+        RemoveThresholdOwner(pThd);
+        // Dequeued first, so released locks are not handed back to it
+        ReleaseRwLockHolds(pThd);
         break;
     }
+    // Contended mutexes still owned are linked on the list of owned mutexes,
+    //   detach them before the list is reinitialized.
+    if (detach) {
+        while (!mosIsListEmpty(&pThd->mtxQ)) mosRemoveFromList(pThd->mtxQ.pNext);
+    }
     SetThreadState(pThd, THREAD_UNINIT);
     UnlockScheduler();
     InitThread(pThd, pri, pEntry, arg, pStackBottom, pStackSize);
@@ -524,9 +1262,8 @@ bool mosRunThread(MosThread * _pThd) {
     if (pThd->state == THREAD_INIT) {
         LockScheduler(IntPriMaskLow);
         SetThreadState(pThd, THREAD_RUNNABLE);
-        if (pThd != &IdleThread)
-            mosAddToEndOfList(&RunQueues[pThd->pri], &pThd->runLink);
-        if (pRunningThread != NO_SUCH_THREAD && pThd->pri < pRunningThread->pri)
+        if (pThd != &IdleThread) AddThreadToRunQueue(pThd);
+        if (pRunningThread != NO_SUCH_THREAD && PreemptsRunningThread(pThd))
             YieldThread();
         UnlockScheduler();
         return true;
@@ -571,58 +1308,223 @@ MosThreadPriority mosGetThreadPriority(MosThread * _pThd) {
     return pThd->pri;
 }
 
+// Check whether event group flags satisfy wait condition
+static MOS_INLINE bool EventFlagsMatch(u32 flags, u32 mask, u32 opts) {
+    if (opts & MOS_EVENT_GROUP_WAIT_ALL) return (flags & mask) == mask;
+    return (flags & mask) != 0;
+}
+
 // Sort thread into pend queue by priority
-MOS_ISR_SAFE static void SortThreadByPriority(Thread * pThd, MosList * pPendQ) {
-    mosRemoveFromList(&pThd->runLink);
-    MosLink * pElm = pPendQ->pNext;
-    for (; pElm != pPendQ; pElm = pElm->pNext) {
+//   Bucketed pend queues insert after the tail of the nearest bucket at the
+//   same or higher priority, found from the bitmap in constant time.
+MOS_ISR_SAFE static void SortThreadByPriority(Thread * pThd, MosPendQ * pPendQ) {
+    RemoveThreadFromList(pThd);
+#if (MOS_PEND_QUEUE_BUCKETS == true)
+    MosThreadPriority pri = pThd->pri;
+    u32 map = pPendQ->map & ((2u << pri) - 1);
+    MosLink * pElm = &pPendQ->list;
+    if (map) pElm = pPendQ->pTail[FindLastSet(map)];
+    mosAddToListBefore(pElm->pNext, &pThd->runLink);
+    pPendQ->pTail[pri] = &pThd->runLink;
+    pPendQ->map |= (1u << pri);
+    pThd->pPendQ = pPendQ;
+    pThd->pendPri = pri;
+#else
+    MosLink * pElm = pPendQ->list.pNext;
+    for (; pElm != &pPendQ->list; pElm = pElm->pNext) {
         Thread * _pThd = container_of(pElm, Thread, runLink);
         if (_pThd->pri > pThd->pri) break;
     }
     mosAddToListBefore(pElm, &pThd->runLink);
+#endif
 }
 
-void mosChangeThreadPriority(MosThread * _pThd, MosThreadPriority newPri) {
-    Thread * pThd = (Thread *)_pThd;
-    LockScheduler(IntPriMaskLow);
-    // Snapshot the running thread priority (in case it gets changed)
-    MosThreadPriority currPri = 0;
-    if (pRunningThread != NO_SUCH_THREAD) currPri = pRunningThread->pri;
-    // Change current priority if priority inheritance isn't active
-    //  -OR- if new priority is higher than priority inheritance priority
-    if (pThd->pri == pThd->nomPri || newPri < pThd->pri) {
-        pThd->pri = newPri;
-        switch (pThd->state) {
-        case THREAD_RUNNABLE:
-            mosRemoveFromList(&pThd->runLink);
-            mosAddToEndOfList(&RunQueues[newPri], &pThd->runLink);
-            break;
-        case THREAD_WAIT_FOR_MUTEX:
-            SortThreadByPriority(pThd, &((MosMutex *)pThd->pBlockedOn)->pendQ);
-            break;
-        case THREAD_WAIT_FOR_SEM:
-        case THREAD_WAIT_FOR_SEM_OR_TICK:
-            SortThreadByPriority(pThd, &((MosSem *)pThd->pBlockedOn)->pendQ);
-            break;
-        default:
-            break;
-        }
-    }
-    // Always change nominal priority
-    pThd->nomPri = newPri;
-    // Yield if priority is lowered on currently running thread
-    //  -OR- if other thread has a greater priority than running thread
-    if (pThd == pRunningThread) {
-        if (pThd->pri > currPri) YieldThread();
-    } else if (pThd->pri < currPri) YieldThread();
-    UnlockScheduler();
+static void InheritPriorityAt(Thread * pThd, MosThreadPriority pri, u32 depth);
+
+// Raise holders of reader-writer lock to priority of a waiter
+//   NOTE: Must lock scheduler before calling.
+static void BoostRwLockHolders(MosRwLock * pLock, MosThreadPriority pri, u32 depth) {
+    InheritPriorityAt((Thread *)pLock->writer.pThd, pri, depth);
+    for (u32 ix = 0; ix < MOS_RWLOCK_READER_SLOTS; ix++)
+        InheritPriorityAt((Thread *)pLock->readers[ix].pThd, pri, depth);
 }
 
-s32 mosWaitForThreadStop(MosThread * _pThd) {
-    Thread * pThd = (Thread *)_pThd;
-    LockScheduler(IntPriMaskLow);
-    if (pThd->state > THREAD_STOPPED) {
-        mosRemoveFromList(&pRunningThread->runLink);
+// Re-sort blocked thread on the pend queue it waits on after a priority
+//   change, passing the priority on to the owners of the lock it waits on.
+//   NOTE: Must lock scheduler before calling.
+static void ResortPendingThread(Thread * pThd, u32 depth) {
+    switch (pThd->state) {
+    case THREAD_WAIT_FOR_MUTEX: {
+        MosMutex * pMtx = (MosMutex *)pThd->pBlockedOn;
+        SortThreadByPriority(pThd, &pMtx->pendQ);
+        InheritPriorityAt((Thread *)pMtx->pOwner, pThd->pri, depth);
+        break;
+    }
+    case THREAD_WAIT_FOR_RWLOCK:
+    case THREAD_WAIT_FOR_RWLOCK_OR_TICK: {
+        MosRwLock * pLock = (MosRwLock *)pThd->pBlockedOn;
+        SortThreadByPriority(pThd, &pLock->pendQ);
+        BoostRwLockHolders(pLock, pThd->pri, depth);
+        break;
+    }
+    case THREAD_WAIT_FOR_CONDVAR:
+    case THREAD_WAIT_FOR_CONDVAR_OR_TICK:
+        SortThreadByPriority(pThd, &((MosCondVar *)pThd->pBlockedOn)->pendQ);
+        break;
+    case THREAD_WAIT_FOR_SEM:
+    case THREAD_WAIT_FOR_SEM_OR_TICK: {
+        // Semaphore pend queues are read by ISRs incrementing the semaphore
+        u32 mask = mosDisableInterrupts();
+        SortThreadByPriority(pThd, &((MosSem *)pThd->pBlockedOn)->pendQ);
+        mosEnableInterrupts(mask);
+        break;
+    }
+    case THREAD_WAIT_FOR_EVENT_GROUP:
+    case THREAD_WAIT_FOR_EVENT_GROUP_OR_TICK: {
+        // Event group pend queues are walked by ISR event handlers
+        u32 mask = mosDisableInterrupts();
+        SortThreadByPriority(pThd, &((MosEventGroup *)pThd->pBlockedOn)->pendQ);
+        mosEnableInterrupts(mask);
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+// Transitive priority inheritance
+//   Raise lock owner to priority of a waiter. If the owner is itself blocked
+//   on a mutex or reader-writer lock the boost is passed on to the owners of
+//   that lock, up to MOS_MAX_INHERIT_DEPTH owners deep, re-sorting the pend
+//   queues on the way.
+//   NOTE: Must lock scheduler before calling.
+static void InheritPriorityAt(Thread * pThd, MosThreadPriority pri, u32 depth) {
+    if (pThd == NO_SUCH_THREAD || pThd->pri <= pri || depth >= MOS_MAX_INHERIT_DEPTH) return;
+    if (pThd->state == THREAD_RUNNABLE) {
+        RemoveThreadFromList(pThd);
+        pThd->pri = pri;
+        AddThreadToFrontOfRunQueue(pThd);
+        return;
+    }
+    pThd->pri = pri;
+    ResortPendingThread(pThd, depth + 1);
+}
+
+static MOS_INLINE void InheritPriority(Thread * pThd, MosThreadPriority pri) {
+    InheritPriorityAt(pThd, pri, 0);
+}
+
+// Recompute priority of thread from its nominal priority and the highest
+//   priority waiters of the contended mutexes and reader-writer locks it
+//   still holds.
+//   NOTE: Must lock scheduler before calling.
+static void RestoreInheritedPriority(Thread * pThd) {
+    MosThreadPriority pri = pThd->nomPri;
+    MosLink * pElm = pThd->mtxQ.pNext;
+    for (; pElm != &pThd->mtxQ; pElm = pElm->pNext) {
+        MosOwnLink * pOwn = container_of(pElm, MosOwnLink, link);
+        MosPendQ * pPendQ = pOwn->pRwLock ? &pOwn->pRwLock->pendQ :
+                                            &container_of(pOwn, MosMutex, ownLink)->pendQ;
+        if (!mosIsListEmpty(&pPendQ->list)) {
+            Thread * pWaiter = container_of(pPendQ->list.pNext, Thread, runLink);
+            if (pWaiter->pri < pri) pri = pWaiter->pri;
+        }
+    }
+    if (pri != pThd->pri) {
+        if (pThd->state == THREAD_RUNNABLE) {
+            RemoveThreadFromList(pThd);
+            pThd->pri = pri;
+            AddThreadToFrontOfRunQueue(pThd);
+        } else pThd->pri = pri;
+        if (pThd == pRunningThread) YieldThread();
+    }
+}
+
+// Move mutex onto contended list of its owner and apply priority inheritance
+//   on behalf of a thread blocking on it.
+//   NOTE: Must lock scheduler before calling.
+static void BoostMutexOwner(MosMutex * pMtx, MosThreadPriority pri) {
+    Thread * pOwner = (Thread *)pMtx->pOwner;
+    if (pOwner != NO_SUCH_THREAD && !mosIsOnList(&pMtx->ownLink.link))
+        mosAddToEndOfList(&pOwner->mtxQ, &pMtx->ownLink.link);
+    InheritPriority(pOwner, pri);
+}
+
+// Release running thread ownership of mutex, recomputing inherited priority.
+//   NOTE: Must lock scheduler before calling.
+static void DisownMutex(MosMutex * pMtx) {
+    if (mosIsOnList(&pMtx->ownLink.link)) mosRemoveFromList(&pMtx->ownLink.link);
+    if (pRunningThread) {
+        pRunningThread->mtxCnt--;
+        RestoreInheritedPriority(pRunningThread);
+    }
+}
+
+// Wake highest priority thread waiting on mutex so it may retry taking it.
+//   NOTE: Must lock scheduler before calling.
+static void WakeMutexWaiter(MosMutex * pMtx) {
+    if (!mosIsListEmpty(&pMtx->pendQ.list)) {
+        Thread * pThd = container_of(pMtx->pendQ.list.pNext, Thread, runLink);
+        RemoveThreadFromPendQ(pThd);
+        AddThreadToFrontOfRunQueue(pThd);
+        if (mosIsOnList(&pThd->tmrLink.link))
+            mosRemoveFromList(&pThd->tmrLink.link);
+        SetThreadState(pThd, THREAD_RUNNABLE);
+        if (PreemptsRunningThread(pThd)) YieldThread();
+    }
+}
+
+void mosSetTimeSlice(MosThreadPriority pri, u32 ticks) {
+    mosAssert(pri < MOS_MAX_THREAD_PRIORITIES);
+    if (ticks > 0xffff) ticks = 0xffff;
+    LockScheduler(IntPriMaskLow);
+    TimeSlices[pri] = (u16)ticks;
+    UnlockScheduler();
+}
+
+void mosChangeThreadPriority(MosThread * _pThd, MosThreadPriority newPri) {
+    Thread * pThd = (Thread *)_pThd;
+    LockScheduler(IntPriMaskLow);
+    // Snapshot the running thread priority (in case it gets changed)
+    MosThreadPriority currPri = 0;
+    if (pRunningThread != NO_SUCH_THREAD) currPri = pRunningThread->pri;
+    // Change current priority if priority inheritance isn't active
+    //  -OR- if new priority is higher than priority inheritance priority
+    if (pThd->pri == pThd->nomPri || newPri < pThd->pri) {
+        if (pThd->state == THREAD_RUNNABLE) {
+            // Remove from run queue at old priority to maintain bitmap
+            RemoveThreadFromList(pThd);
+            pThd->pri = newPri;
+            AddThreadToRunQueue(pThd);
+        } else {
+            pThd->pri = newPri;
+            ResortPendingThread(pThd, 0);
+        }
+    }
+    // Always change nominal priority
+    pThd->nomPri = newPri;
+    // Yield if priority is lowered on currently running thread
+    //  -OR- if other thread has a greater priority than running thread
+    if (pThd == pRunningThread) {
+        if (pThd->pri > currPri) YieldThread();
+    } else if (pThd->pri < currPri && PreemptsRunningThread(pThd)) YieldThread();
+    UnlockScheduler();
+}
+
+void mosSetPreemptThreshold(MosThread * _pThd, MosThreadPriority threshold) {
+    Thread * pThd = (Thread *)_pThd;
+    LockScheduler(IntPriMaskLow);
+    pThd->threshold = threshold;
+    // Waiting threads may now be allowed to preempt
+    if (pThd == pRunningThread) YieldThread();
+    UnlockScheduler();
+}
+
+s32 mosWaitForThreadStop(MosThread * _pThd) {
+    Thread * pThd = (Thread *)_pThd;
+    LockScheduler(IntPriMaskLow);
+    if (pThd->state > THREAD_STOPPED) {
+        RemoveThreadFromList(pRunningThread);
         mosAddToEndOfList(&pThd->stopQ, &pRunningThread->runLink);
         SetThreadState(pRunningThread, THREAD_WAIT_FOR_STOP);
         YieldThread();
@@ -637,7 +1539,7 @@ bool mosWaitForThreadStopOrTO(MosThread * _pThd, s32 * pRtnVal, u32 ticks) {
     pRunningThread->timedOut = 0;
     LockScheduler(IntPriMaskLow);
     if (pThd->state > THREAD_STOPPED) {
-        mosRemoveFromList(&pRunningThread->runLink);
+        RemoveThreadFromList(pRunningThread);
         mosAddToEndOfList(&pThd->stopQ, &pRunningThread->runLink);
         SetThreadState(pRunningThread, THREAD_WAIT_FOR_STOP_OR_TICK);
         YieldThread();
@@ -648,6 +1550,44 @@ bool mosWaitForThreadStopOrTO(MosThread * _pThd, s32 * pRtnVal, u32 ticks) {
     return true;
 }
 
+#if (MOS_ENABLE_CPU_BUDGETS == true)
+
+void mosSetThreadBudget(MosThread * _pThd, u32 cycles, u32 period) {
+    Thread * pThd = (Thread *)_pThd;
+    LockScheduler(IntPriMaskLow);
+    pThd->budget = cycles;
+    pThd->budgetPeriod = period;
+    pThd->budgetLeft = (s32)cycles;
+    pThd->replenishTick = Tick.lower + period;
+    UnlockScheduler();
+}
+
+// Charge running thread for cycles consumed since last charge. If its budget
+//   is exhausted have it wait for replenishment, unless it holds a mutex.
+//   Returns true if the running thread was suspended.
+static bool ChargeRunningThread(void) {
+    u32 now = (u32)mosGetCycleCount();
+    u32 used = now - ChargeCycles;
+    ChargeCycles = now;
+    Thread * pThd = pRunningThread;
+    if (pThd->budget == 0) return false;
+    u32 tick = Tick.lower;
+    if ((s32)(tick - pThd->replenishTick) >= 0) {
+        pThd->budgetLeft += (s32)pThd->budget;
+        if (pThd->budgetLeft > (s32)pThd->budget) pThd->budgetLeft = (s32)pThd->budget;
+        pThd->replenishTick += pThd->budgetPeriod;
+        if ((s32)(tick - pThd->replenishTick) >= 0)
+            pThd->replenishTick = tick + pThd->budgetPeriod;
+    }
+    pThd->budgetLeft -= (s32)used;
+    if (pThd->budgetLeft > 0 || pThd->state != THREAD_RUNNABLE || pThd->mtxCnt) return false;
+    pThd->wakeTick = pThd->replenishTick;
+    SetThreadState(pThd, THREAD_WAIT_FOR_TICK);
+    return true;
+}
+
+#endif
+
 void mosKillThread(MosThread * _pThd) {
     Thread * pThd = (Thread *)_pThd;
     if (pThd == pRunningThread) {
@@ -656,7 +1596,8 @@ void mosKillThread(MosThread * _pThd) {
         mosAssert(0);
     } else {
         // Snapshot the arguments, run thread stop handler, allowing thread
-        //   to stop at its original run priority.
+        //   to stop at its original run priority. Reinitializing the thread
+        //   withdraws it from any queue, including a pending notification.
         LockScheduler(IntPriMaskLow);
         MosThreadPriority pri = pThd->pri;
         MosThreadEntry * pStopHandler = pThd->pTermHandler;
@@ -736,6 +1677,11 @@ void mosInit(u32 clockSpeedHz) {
     }
     MOS_REG(SHPR)(MOS_SYSTICK_IRQ  - 4) = priSystick;
     IntPriMaskLow = priSystick;
+#if (MOS_BASEPRI_CRITICAL_SECTIONS == true)
+    // Max syscall priority must be implemented and above SysTick and PendSV
+    mosAssert((MOS_MAX_SYSCALL_INT_PRIORITY & ~priMask & 0xff) == 0 &&
+              MOS_MAX_SYSCALL_INT_PRIORITY < priSystick);
+#endif
 #elif (MOS_ARCH_CAT == MOS_ARCH_ARM_CORTEX_M_BASE)
     // NOTE: BASEPRI isn't implemented on baseline architectures, hence IntPriMaskLow is not used
     // Set lowest preemption priority for SysTick and PendSV
@@ -751,13 +1697,28 @@ void mosInit(u32 clockSpeedHz) {
     mosInitSem(&SecureContextCounter, MOS_NUM_SECURE_CONTEXTS);
 #endif
     // Initialize empty queues
-    for (MosThreadPriority pri = 0; pri < MOS_MAX_THREAD_PRIORITIES; pri++)
+    for (MosThreadPriority pri = 0; pri < MOS_MAX_THREAD_PRIORITIES; pri++) {
         mosInitList(&RunQueues[pri]);
-    mosInitList(&ISREventQueue);
-    mosInitList(&TimerQueue);
+        TimeSlices[pri] = MOS_DEFAULT_TIME_SLICE;
+    }
+    for (u32 type = 0; type < ISR_EVT_TYPES; type++)
+        mosInitList(&ISREventQueues[type]);
+    for (u32 level = 0; level < TIMER_WHEEL_LEVELS; level++) {
+        for (u32 slot = 0; slot < TIMER_WHEEL_SLOTS; slot++)
+            mosInitList(&TimerWheel[level][slot]);
+    }
+    mosInitList(&TimerOverflowQueue);
+    TimerTick = Tick.lower + 1;
     // Create idle thread
     mosInitAndRunThread((MosThread *) &IdleThread, MOS_MAX_THREAD_PRIORITIES,
                         IdleThreadEntry, 0, IdleStack, sizeof(IdleStack));
+#if (MOS_ENABLE_DEFERRED_TIMERS == true)
+    // Create timer service thread
+    mosInitList(&DeferredTimerQueue);
+    mosInitAndRunThread((MosThread *) &TimerThread, MOS_TIMER_THREAD_PRIORITY,
+                        TimerThreadEntry, 0, TimerStack, sizeof(TimerStack));
+    mosSetThreadName((MosThread *) &TimerThread, "timer");
+#endif
 }
 
 //
@@ -792,43 +1753,174 @@ void SysTick_Handler(void) {
     if (MOS_REG(TICK_CTRL) & MOS_REG_VALUE(TICK_FLAG)) Tick.count += 1;
     _mosEnableInterrupts();
     if (pRunningThread == NO_SUCH_THREAD) return;
-    // Process timer queue
-    //  Timer queues can contain threads or message timers
-    MosLink * pElmSave;
-    for (MosLink * pElm = TimerQueue.pNext; pElm != &TimerQueue; pElm = pElmSave) {
-        pElmSave = pElm->pNext;
-        if (((MosPmLink *)pElm)->type == ELM_THREAD) {
-            Thread * pThd = container_of(pElm, Thread, tmrLink);
-            s32 remTicks = (s32)pThd->wakeTick - Tick.lower;
-            if (remTicks <= 0) {
-                mosRemoveFromList(pElm);
-                if (pThd->state == THREAD_WAIT_FOR_SEM_OR_TICK) {
-                    _mosDisableInterrupts();
-                    if (mosIsOnList(&((MosSem *)pThd->pBlockedOn)->evtLink)) {
-                        // Event occurred before timeout, just let it be processed
-                        _mosEnableInterrupts();
-                        continue;
-                    } else {
-                        mosRemoveFromList(&pThd->runLink);
-                        _mosEnableInterrupts();
-                    }
-                } else mosRemoveFromList(&pThd->runLink);
-                mosAddToEndOfList(&RunQueues[pThd->pri], &pThd->runLink);
-                pThd->timedOut = 1;
-                SetThreadState(pThd, THREAD_RUNNABLE);
-            } else break;
+    // Process timer wheel up to current tick
+    //   Catches up on ticks skipped by tickless idle or mosAdvanceTickCount(),
+    //   skipping directly over empty level 0 slots.
+    u32 tick = Tick.lower;
+    bool yield = false;
+    while ((s32)(tick - TimerTick) >= 0) {
+        if (TimerWheelMap[0] == 0 && (TimerTick & TIMER_WHEEL_MASK)) {
+            u32 nextTick = (TimerTick + TIMER_WHEEL_MASK) & ~TIMER_WHEEL_MASK;
+            if ((s32)(nextTick - tick) > 0) nextTick = tick + 1;
+            TimerTick = nextTick;
+        } else if (ProcessTimerTick()) yield = true;
+    }
+#if (MOS_ENABLE_EDF == true)
+    CheckEdfDeadlines();
+#endif
+#if (MOS_ENABLE_CPU_BUDGETS == true)
+    // Enforce CPU budget of running thread
+    if (ChargeRunningThread()) yield = true;
+#endif
+    // Round-robin running thread when its time slice expires, or if another
+    //   thread of the same priority was queued in front of it.
+    //   In the EDF band preempt if another thread has an earlier deadline.
+    //   Threads running under a preemption threshold are not sliced.
+    if (pRunningThread != &IdleThread && pRunningThread->state == THREAD_RUNNABLE &&
+            pRunningThread->threshold >= pRunningThread->pri) {
+        if (IS_EDF_PRI(pRunningThread->pri)) {
+#if (MOS_ENABLE_EDF == true)
+            if (EdfHeap[1] != pRunningThread) yield = true;
+#endif
         } else {
-            MosTimer * pTmr = container_of(pElm, MosTimer, tmrLink);
-            s32 remTicks = (s32)pTmr->wakeTick - Tick.lower;
-            if (remTicks <= 0) {
-                if ((pTmr->pCallback)(pTmr)) mosRemoveFromList(pElm);
-            } else break;
+            MosList * pRunQueue = &RunQueues[pRunningThread->pri];
+            if (pRunningThread->sliceLeft && --pRunningThread->sliceLeft == 0) {
+                pRunningThread->sliceLeft = TimeSlices[pRunningThread->pri];
+                if (pRunQueue->pNext != pRunQueue->pPrev) {
+                    mosMoveToEndOfList(pRunQueue, &pRunningThread->runLink);
+                    yield = true;
+                }
+            }
+            if (pRunQueue->pNext != &pRunningThread->runLink) yield = true;
         }
     }
-    YieldThread();
+    // Only invoke scheduler if there is something for it to do: a thread
+    //   preempts the running thread, ISR events are pending, or the running
+    //   thread must round-robin with threads of the same priority.
+    if (yield || ISREventMap) YieldThread();
+    else AvoidedContextSwitches++;
+    // Track worst case duration since tick fired
+    u32 cycles = MOS_REG(TICK_LOAD) - MOS_REG(TICK_VAL);
+    if (cycles > MaxTickCycles) MaxTickCycles = cycles;
     EVENT(TICK, Tick.lower);
 }
 
+// Track longest interrupt disable window of ISR event processing,
+//   start is the tick counter value sampled after interrupts were disabled.
+static MOS_INLINE void RecordISREventLock(u32 start) {
+    u32 now = MOS_REG(TICK_VAL);
+    u32 cycles = (start >= now) ? start - now : start + MOS_REG(TICK_LOAD) + 1 - now;
+    if (cycles > MaxISREventLockCycles) MaxISREventLockCycles = cycles;
+}
+
+// Semaphore given: release as many pending threads as the count allows,
+//   one short critical section per released thread.
+static void HandleSemEvent(MosLink * pElm) {
+    MosSem * pSem = container_of(pElm, MosSem, evtLink);
+    MosList woken;
+    mosInitList(&woken);
+    u32 released = 0;
+    while (1) {
+        _mosDisableInterrupts();
+        u32 start = MOS_REG(TICK_VAL);
+        // Always release the first pending thread (as a timeout may have been
+        //   deferred to this event), then as many more as the count allows
+        if ((released == 0 || released < pSem->value) && !mosIsListEmpty(&pSem->pendQ.list)) {
+            Thread * pThd = container_of(pSem->pendQ.list.pNext, Thread, runLink);
+            RemoveThreadFromPendQ(pThd);
+            mosAddToEndOfList(&woken, &pThd->runLink);
+            released++;
+            RecordISREventLock(start);
+            _mosEnableInterrupts();
+        } else {
+            // Dequeue event last so that ISRs may requeue it
+            mosRemoveFromList(pElm);
+            RecordISREventLock(start);
+            _mosEnableInterrupts();
+            break;
+        }
+    }
+    // Add to front of run queues in reverse to preserve pend order
+    while (!mosIsListEmpty(&woken)) {
+        Thread * pThd = container_of(woken.pPrev, Thread, runLink);
+        mosRemoveFromList(&pThd->runLink);
+        AddThreadToFrontOfRunQueue(pThd);
+        if (mosIsOnList(&pThd->tmrLink.link))
+            mosRemoveFromList(&pThd->tmrLink.link);
+        SetThreadState(pThd, THREAD_RUNNABLE);
+    }
+}
+
+// Event flags set: all waiters of a group are resolved in a single pass
+//   against the flags as they were set, auto-clearing matched flags afterwards.
+//   ISRs only peek at the head of the pend queue, so it is walked with
+//   interrupts enabled, each released waiter being removed in a short
+//   critical section.
+static void HandleEventGroupEvent(MosLink * pElm) {
+    MosEventGroup * pGrp = container_of(pElm, MosEventGroup, evtLink);
+    _mosDisableInterrupts();
+    u32 start = MOS_REG(TICK_VAL);
+    // Flags set from here on requeue the event
+    mosRemoveFromList(pElm);
+    u32 flags = pGrp->flags, clear = 0;
+    RecordISREventLock(start);
+    _mosEnableInterrupts();
+    MosLink * pElmSave;
+    for (pElm = pGrp->pendQ.list.pNext; pElm != &pGrp->pendQ.list; pElm = pElmSave) {
+        pElmSave = pElm->pNext;
+        Thread * pThd = container_of(pElm, Thread, runLink);
+        if (!EventFlagsMatch(flags, pThd->evtMask, pThd->evtOpts)) continue;
+        _mosDisableInterrupts();
+        start = MOS_REG(TICK_VAL);
+        RemoveThreadFromPendQ(pThd);
+        RecordISREventLock(start);
+        _mosEnableInterrupts();
+        pThd->evtMask &= flags;
+        if (pThd->evtOpts & MOS_EVENT_GROUP_AUTO_CLEAR) clear |= pThd->evtMask;
+        AddThreadToRunQueue(pThd);
+        if (mosIsOnList(&pThd->tmrLink.link))
+            mosRemoveFromList(&pThd->tmrLink.link);
+        SetThreadState(pThd, THREAD_RUNNABLE);
+    }
+    if (clear) {
+        _mosDisableInterrupts();
+        pGrp->flags &= ~clear;
+        _mosEnableInterrupts();
+    }
+}
+
+// Thread notified: the thread itself is queued on its run link
+static void HandleNotifyEvent(MosLink * pElm) {
+    Thread * pThd = container_of(pElm, Thread, runLink);
+    _mosDisableInterrupts();
+    u32 start = MOS_REG(TICK_VAL);
+    mosRemoveFromList(pElm);
+    SetThreadState(pThd, THREAD_RUNNABLE);
+    RecordISREventLock(start);
+    _mosEnableInterrupts();
+    AddThreadToFrontOfRunQueue(pThd);
+    if (mosIsOnList(&pThd->tmrLink.link))
+        mosRemoveFromList(&pThd->tmrLink.link);
+}
+
+// User event: dequeue before invoking the handler so it may be reposted
+static void HandleCallbackEvent(MosLink * pElm) {
+    MosISREvent * pEvt = container_of(pElm, MosISREvent, evtLink);
+    _mosDisableInterrupts();
+    u32 start = MOS_REG(TICK_VAL);
+    mosRemoveFromList(pElm);
+    RecordISREventLock(start);
+    _mosEnableInterrupts();
+    (pEvt->pHandler)(pEvt);
+}
+
+static void (* const ISREventHandlers[ISR_EVT_TYPES])(MosLink * pElm) = {
+    [ISR_EVT_SEM]         = HandleSemEvent,
+    [ISR_EVT_EVENT_GROUP] = HandleEventGroupEvent,
+    [ISR_EVT_NOTIFY]      = HandleNotifyEvent,
+    [ISR_EVT_CALLBACK]    = HandleCallbackEvent,
+};
+
 // Locking notes:
 //   Since semaphore data structures can be manipulated in high-priority
 //   ISR contexts interrupt disable is required to ensure data integrity.
@@ -836,18 +1928,32 @@ void SysTick_Handler(void) {
 //   event queue or manipulates/inspects semaphore pend queues.  For
 //   mutexes and timers changing BASEPRI provides sufficient locking.
 
+#if (MOS_ARCH_CAT == MOS_ARCH_ARM_CORTEX_M_BASE)
+MOS_ISR_SAFE static void RewindRas(void);
+#endif
+
 static u32 MOS_USED Scheduler(u32 sp) {
     EVENT(SCHEDULER_ENTRY, 0);
     // Save SP and pErrNo context
-    if (pRunningThread != NO_SUCH_THREAD) {
+    bool firstRun = (pRunningThread == NO_SUCH_THREAD);
+    if (!firstRun) {
         pRunningThread->sp = sp;
         pRunningThread->errNo = *pErrNo;
+#if (MOS_ARCH_CAT == MOS_ARCH_ARM_CORTEX_M_BASE)
+        // Another thread might run before this one commits a sequence
+        RewindRas();
+#endif
     } else {
         pRunningThread = &IdleThread;
 #if (MOS_ARM_RTOS_ON_NON_SECURE_SIDE == true)
         _NSC_mosInitSecureContexts(KPrint, RawPrintBuffer);
 #endif
     }
+    pRunningThread->preemptHeld = 0;
+#if (MOS_ENABLE_CPU_BUDGETS == true)
+    // Enforce CPU budget, thread waits for a tick if exhausted
+    ChargeRunningThread();
+#endif
     // Update Running Thread state
     //   Threads can't directly kill themselves, so do it here.
     //   If thread needs to go onto timer queue, do it here.
@@ -855,73 +1961,82 @@ static u32 MOS_USED Scheduler(u32 sp) {
         // Arrange death of running thread via kill handler
         if (mosIsOnList(&pRunningThread->tmrLink.link))
             mosRemoveFromList(&pRunningThread->tmrLink.link);
+        ReleaseRwLockHolds(pRunningThread);
+        // Priority is reset to nominal, so requeue the thread
+        RemoveThreadFromList(pRunningThread);
         ReInitThread(pRunningThread, pRunningThread->pTermHandler, pRunningThread->termArg);
         SetThreadState(pRunningThread, THREAD_RUNNABLE);
+        AddThreadToRunQueue(pRunningThread);
     } else if (pRunningThread->state & THREAD_STATE_TICK) {
-        // Update running thread timer state (insertion sort in timer queue)
-        s32 remTicks = (s32)pRunningThread->wakeTick - Tick.lower;
-        MosLink * pElm;
-        for (pElm = TimerQueue.pNext; pElm != &TimerQueue; pElm = pElm->pNext) {
-            s32 wakeTick;
-            if (((MosPmLink *)pElm)->type == ELM_THREAD) {
-                Thread * pThd = container_of(pElm, Thread, tmrLink);
-                wakeTick = (s32)pThd->wakeTick;
-            } else {
-                MosTimer * pTmr = container_of(pElm, MosTimer, tmrLink);
-                wakeTick = (s32)pTmr->wakeTick;
-            }
-            s32 tmrRemTicks = wakeTick - Tick.lower;
-            if (remTicks <= tmrRemTicks) break;
-        }
-        mosAddToListBefore(pElm, &pRunningThread->tmrLink.link);
+        // Update running thread timer state
+        AddToTimerWheel(&pRunningThread->tmrLink, pRunningThread->wakeTick);
         // If thread is only waiting for a tick
         if (pRunningThread->state == THREAD_WAIT_FOR_TICK)
-            mosRemoveFromList(&pRunningThread->runLink);
+            RemoveThreadFromList(pRunningThread);
     }
-    // Process ISR event queue
-    //  Event queue allows ISRs to signal semaphores without directly
-    //  manipulating run queues, making critical sections shorter
+    // Process ISR events
+    //  Event queues allow ISRs to signal the kernel without directly
+    //  manipulating run queues, making critical sections shorter.
+    //  Each queue is detached as a whole, elements remain marked as
+    //  queued (linked on the batch) until their handler dequeues them
+    //  so ISRs don't requeue them meanwhile. Handlers may post further
+    //  events, which are processed in the same pass.
+    u32 events = 0;
     while (1) {
+        MosList batch;
         _mosDisableInterrupts();
-        if (!mosIsListEmpty(&ISREventQueue)) {
-            MosLink * pElm = ISREventQueue.pNext;
-            mosRemoveFromList(pElm);
-            // Currently only semaphores are on event list
-            MosSem * pSem = container_of(pElm, MosSem, evtLink);
-            // Release thread if it is pending
-            if (!mosIsListEmpty(&pSem->pendQ)) {
-                MosLink * pElm = pSem->pendQ.pNext;
-                mosRemoveFromList(pElm);
-                _mosEnableInterrupts();
-                Thread * pThd = container_of(pElm, Thread, runLink);
-                mosAddToFrontOfList(&RunQueues[pThd->pri], pElm);
-                if (mosIsOnList(&pThd->tmrLink.link))
-                    mosRemoveFromList(&pThd->tmrLink.link);
-                SetThreadState(pThd, THREAD_RUNNABLE);
-            } else _mosEnableInterrupts();
-        } else {
+        u32 start = MOS_REG(TICK_VAL);
+        if (ISREventMap == 0) {
             _mosEnableInterrupts();
             break;
         }
+        ISREventType type = (ISREventType)FindFirstSet(ISREventMap);
+        ISREventMap &= ~(1 << type);
+        TakeList(&batch, &ISREventQueues[type]);
+        RecordISREventLock(start);
+        _mosEnableInterrupts();
+        while (!mosIsListEmpty(&batch)) {
+            (ISREventHandlers[type])(batch.pNext);
+            events++;
+        }
     }
+    if (events > MaxISREventBatch) MaxISREventBatch = events;
     // Process Priority Queues
-    // Start scan at first thread of highest priority, looking for first
-    //  thread of list, and if no threads are runnable schedule idle thread.
-    Thread * runThd = NULL;
-    for (MosThreadPriority pri = 0; pri < MOS_MAX_THREAD_PRIORITIES; pri++) {
-        if (!mosIsListEmpty(&RunQueues[pri])) {
-            runThd = container_of(RunQueues[pri].pNext, Thread, runLink);
-            break;
+    //  Look up highest priority non-empty run queue in the bitmap, taking
+    //  the first thread of that list. If no threads are runnable schedule
+    //  idle thread. Round-robin rotation happens on time slice expiration
+    //  (SysTick) or on yield, so the running thread stays at the front.
+    Thread * runThd = &IdleThread;
+    MosThreadPriority pri = GetTopRunQueue();
+#if (MOS_ENABLE_EDF == true)
+    if (IS_EDF_PRI(pri)) runThd = EdfHeap[1];
+    else
+#endif
+    if (pri < MOS_MAX_THREAD_PRIORITIES)
+        runThd = container_of(RunQueues[pri].pNext, Thread, runLink);
+    // Thread holding a preemption threshold continues unless the top priority
+    //   is above its threshold. It stays the owner when preempted, so it
+    //   resumes ahead of threads below its threshold once those above it
+    //   block. A thread relinquishing the CPU gives up ownership until it
+    //   runs again.
+    Thread * pOwner = GetThresholdOwner();
+    if (Relinquish) {
+        if (pOwner == pRunningThread) {
+            ThresholdOwnerCnt--;
+            pOwner = GetThresholdOwner();
         }
+    } else if (pOwner != pRunningThread && pRunningThread->state == THREAD_RUNNABLE &&
+                   pRunningThread->threshold < pRunningThread->pri) {
+        RemoveThresholdOwner(pRunningThread);
+        mosAssert(ThresholdOwnerCnt < MOS_MAX_THREAD_PRIORITIES);
+        ThresholdOwners[ThresholdOwnerCnt++] = pRunningThread;
+        pOwner = pRunningThread;
     }
-    if (runThd) {
-        // Round-robin
-        if (!mosIsAtEndOfList(&RunQueues[runThd->pri], &runThd->runLink))
-            mosMoveToEndOfList(&RunQueues[runThd->pri], &runThd->runLink);
-    } else runThd = &IdleThread;
-    if (MOS_ENABLE_SPLIM_SUPPORT) {
-        asm volatile ( "msr psplim, %0" : : "r" (runThd->pStackBottom) );
+    if (pOwner != NO_SUCH_THREAD && runThd != pOwner && pri >= pOwner->threshold) {
+        runThd = pOwner;
+        pOwner->preemptHeld = 1;
     }
+    Relinquish = false;
 #if (MOS_ARM_RTOS_ON_NON_SECURE_SIDE == true)
     // If there is a new secure context, only load the next context, don't save it.
     // otherwise only save/load the context if it is different.
@@ -931,6 +2046,15 @@ static u32 MOS_USED Scheduler(u32 sp) {
     } else if (pRunningThread->secureContext != runThd->secureContext)
         _NSC_mosSwitchSecureContext(pRunningThread->secureContext, runThd->secureContext);
 #endif
+    // Fast exit if running thread continues, its stack limit and errno are
+    //   already in place (stack pointer may have changed if thread was stopped).
+    if (runThd == pRunningThread && !firstRun) {
+        EVENT(SCHEDULER_EXIT, 0);
+        return (u32)pRunningThread->sp;
+    }
+    if (MOS_ENABLE_SPLIM_SUPPORT) {
+        asm volatile ( "msr psplim, %0" : : "r" (runThd->pStackBottom) );
+    }
     // Set next thread ID and errno and return its stack pointer
     pRunningThread = runThd;
     *pErrNo = pRunningThread->errNo;
@@ -945,7 +2069,9 @@ static u32 MOS_USED Scheduler(u32 sp) {
 void mosInitMutex(MosMutex * pMtx) {
     pMtx->pOwner = NO_SUCH_THREAD;
     pMtx->depth = 0;
-    mosInitList(&pMtx->pendQ);
+    InitPendQ(&pMtx->pendQ);
+    mosInitList(&pMtx->ownLink.link);
+    pMtx->ownLink.pRwLock = NULL;
 }
 
 void mosRestoreMutex(MosMutex * pMtx) {
@@ -959,14 +2085,635 @@ bool mosIsMutexOwner(MosMutex * pMtx) {
     return (pMtx->pOwner == (void *)pRunningThread);
 }
 
+//
+// Ceiling Mutex
+//
+//   Locking raises the preemption threshold of the owner to the ceiling, so
+//   no other thread that uses the mutex can run until it is unlocked, even
+//   while the owner is preempted. The embedded mutex is then always free on
+//   a single core. It is contended only if the ceiling is too low or the
+//   owner blocked while holding it, in which case the caller blocks and the
+//   owner inherits its priority.
+//
+
+void mosInitCeilingMutex(MosCeilingMutex * pMtx, MosThreadPriority ceiling) {
+    mosInitMutex(&pMtx->mtx);
+    pMtx->ceiling = ceiling;
+    pMtx->savedThreshold = MOS_NO_PREEMPT_THRESHOLD;
+}
+
+void mosLockCeilingMutex(MosCeilingMutex * pMtx) {
+    Thread * pThd = pRunningThread;
+    if (pMtx->mtx.pOwner != (MosThread *)pThd) {
+        MosThreadPriority threshold = pThd->threshold;
+        if (pMtx->ceiling < threshold) pThd->threshold = pMtx->ceiling;
+        mosLockMutex(&pMtx->mtx);
+        // Saved only once taken, a blocked caller must not overwrite it
+        pMtx->savedThreshold = threshold;
+    } else mosLockMutex(&pMtx->mtx);
+}
+
+void mosUnlockCeilingMutex(MosCeilingMutex * pMtx) {
+    if (pMtx->mtx.depth > 1) {
+        mosUnlockMutex(&pMtx->mtx);
+        return;
+    }
+    Thread * pThd = pRunningThread;
+    MosThreadPriority threshold = pMtx->savedThreshold;
+    mosUnlockMutex(&pMtx->mtx);
+    // ISRs flag held-off preemptions, so restore the threshold and sample
+    //   the flag together. Later ISRs see the restored threshold instead.
+    u32 mask = mosDisableInterrupts();
+    pThd->threshold = threshold;
+    bool held = pThd->preemptHeld;
+    mosEnableInterrupts(mask);
+    if (held) YieldThread();
+}
+
+//
+// Condition Variable
+//
+
+void mosInitCondVar(MosCondVar * pCv, MosMutex * pMtx) {
+    pCv->pMtx = pMtx;
+    InitPendQ(&pCv->pendQ);
+}
+
+// Release mutex at any recursion depth and wait on condition variable, then
+//   reacquire mutex at the same depth.
+static bool WaitForCondVar(MosCondVar * pCv, bool timed) {
+    MosMutex * pMtx = pCv->pMtx;
+    LockScheduler(IntPriMaskLow);
+    s32 depth = pMtx->depth;
+    pMtx->depth = 0;
+    pMtx->pOwner = NO_SUCH_THREAD;
+    DisownMutex(pMtx);
+    WakeMutexWaiter(pMtx);
+    SortThreadByPriority(pRunningThread, &pCv->pendQ);
+    pRunningThread->timedOut = 0;
+    pRunningThread->pBlockedOn = pCv;
+    SetThreadState(pRunningThread, timed ? THREAD_WAIT_FOR_CONDVAR_OR_TICK :
+                                           THREAD_WAIT_FOR_CONDVAR);
+    YieldThread();
+    UnlockScheduler();
+    // Signaled threads may have been moved onto the mutex pend queue already
+    mosLockMutex(pMtx);
+    pMtx->depth = depth;
+    return !pRunningThread->timedOut;
+}
+
+void mosWaitForCondVar(MosCondVar * pCv) {
+    WaitForCondVar(pCv, false);
+}
+
+bool mosWaitForCondVarOrTO(MosCondVar * pCv, u32 ticks) {
+    SetTimeout(ticks);
+    return WaitForCondVar(pCv, true);
+}
+
+// Release waiters from condition variable. If the mutex is free the first is
+//   made runnable, otherwise waiters are moved straight onto the mutex pend
+//   queue (wait morphing), so they are woken one at a time as it is released.
+static void SignalCondVar(MosCondVar * pCv, bool all) {
+    MosMutex * pMtx = pCv->pMtx;
+    LockScheduler(IntPriMaskLow);
+    while (!mosIsListEmpty(&pCv->pendQ.list)) {
+        Thread * pThd = container_of(pCv->pendQ.list.pNext, Thread, runLink);
+        if (mosIsOnList(&pThd->tmrLink.link))
+            mosRemoveFromList(&pThd->tmrLink.link);
+        if (pMtx->pOwner == NO_SUCH_THREAD && mosIsListEmpty(&pMtx->pendQ.list)) {
+            RemoveThreadFromPendQ(pThd);
+            AddThreadToRunQueue(pThd);
+            SetThreadState(pThd, THREAD_RUNNABLE);
+            if (PreemptsRunningThread(pThd)) YieldThread();
+        } else {
+            SortThreadByPriority(pThd, &pMtx->pendQ);
+            pThd->pBlockedOn = pMtx;
+            SetThreadState(pThd, THREAD_WAIT_FOR_MUTEX);
+            BoostMutexOwner(pMtx, pThd->pri);
+        }
+        if (!all) break;
+    }
+    UnlockScheduler();
+}
+
+void mosSignalCondVar(MosCondVar * pCv) {
+    SignalCondVar(pCv, false);
+}
+
+void mosBroadcastCondVar(MosCondVar * pCv) {
+    SignalCondVar(pCv, true);
+}
+
+//
+// Reader-Writer Lock
+//
+//   The state word holds the reader count or the writer flag. Once a thread
+//   waits, the waiting flag queues new readers behind it. Operations run with
+//   the scheduler locked, so each hold (the writer and tracked readers) is
+//   recorded in the lock and linked on the held lock list of its thread
+//   together with the state update. Holders thereby inherit the priority of
+//   waiters across unrelated unlocks, and a stopping thread releases them.
+//   There is no compare-and-swap fast path: a thread preempted between the
+//   state update and the hold record would leave a hold that waiters cannot
+//   boost and a killed thread cannot release, and the list of held locks is
+//   only safe to modify with the scheduler locked.
+//   Release hands the lock directly to the threads it wakes.
+//
+
+#define RWLOCK_WRITER         0x80000000
+#define RWLOCK_WAITING        0x40000000
+
+static void InitRwLockHold(MosRwLock * pLock, MosRwLockHold * pHold) {
+    pHold->pThd = NO_SUCH_THREAD;
+    mosInitList(&pHold->ownLink.link);
+    pHold->ownLink.pRwLock = pLock;
+}
+
+void mosInitRwLock(MosRwLock * pLock) {
+    pLock->state = 0;
+    InitRwLockHold(pLock, &pLock->writer);
+    for (u32 ix = 0; ix < MOS_RWLOCK_READER_SLOTS; ix++)
+        InitRwLockHold(pLock, &pLock->readers[ix]);
+    InitPendQ(&pLock->pendQ);
+}
+
+// Find hold of lock by thread, or a free reader slot if pThd is NO_SUCH_THREAD
+static MosRwLockHold * FindRwLockHold(MosRwLock * pLock, Thread * pThd, u32 access) {
+    if (access == RWLOCK_WRITER) return &pLock->writer;
+    for (u32 ix = 0; ix < MOS_RWLOCK_READER_SLOTS; ix++) {
+        if (pLock->readers[ix].pThd == (MosThread *)pThd) return &pLock->readers[ix];
+    }
+    return NULL;
+}
+
+// Record hold of lock by thread (readers are untracked if slots run out)
+//   NOTE: Must lock scheduler before calling.
+static void AddRwLockHold(MosRwLock * pLock, Thread * pThd, u32 access) {
+    MosRwLockHold * pHold = FindRwLockHold(pLock, NO_SUCH_THREAD, access);
+    if (pHold) {
+        pHold->pThd = (MosThread *)pThd;
+        mosAddToEndOfList(&pThd->mtxQ, &pHold->ownLink.link);
+    }
+    pThd->mtxCnt++;
+}
+
+// Hand lock to the waiter at the head of the pend queue, either a writer or
+//   every reader queued ahead of the first writer, and update waiting flag.
+//   NOTE: Must lock scheduler before calling.
+static void GrantRwLock(MosRwLock * pLock) {
+    u32 state = pLock->state & ~RWLOCK_WAITING;
+    while (!mosIsListEmpty(&pLock->pendQ.list)) {
+        Thread * pThd = container_of(pLock->pendQ.list.pNext, Thread, runLink);
+        if (pThd->evtOpts & RWLOCK_WRITER) {
+            if (state) break;
+            state = RWLOCK_WRITER;
+        } else {
+            if (state & RWLOCK_WRITER) break;
+            state++;
+        }
+        AddRwLockHold(pLock, pThd, pThd->evtOpts);
+        RemoveThreadFromPendQ(pThd);
+        AddThreadToRunQueue(pThd);
+        if (mosIsOnList(&pThd->tmrLink.link))
+            mosRemoveFromList(&pThd->tmrLink.link);
+        SetThreadState(pThd, THREAD_RUNNABLE);
+        if (PreemptsRunningThread(pThd)) YieldThread();
+    }
+    if (!mosIsListEmpty(&pLock->pendQ.list)) state |= RWLOCK_WAITING;
+    pLock->state = state;
+}
+
+// Drop hold of lock by thread and pass lock on to waiters
+//   NOTE: Must lock scheduler before calling.
+static void ReleaseRwLock(MosRwLock * pLock, Thread * pThd, u32 access) {
+    MosRwLockHold * pHold = FindRwLockHold(pLock, pThd, access);
+    if (pHold) {
+        pHold->pThd = NO_SUCH_THREAD;
+        mosRemoveFromList(&pHold->ownLink.link);
+    }
+    pThd->mtxCnt--;
+    if (access == RWLOCK_WRITER) pLock->state &= ~RWLOCK_WRITER;
+    else pLock->state--;
+    GrantRwLock(pLock);
+}
+
+// Release tracked reader-writer lock holds of a stopping thread
+//   NOTE: Must lock scheduler before calling.
+static void ReleaseRwLockHolds(Thread * pThd) {
+    MosLink * pElmSave;
+    for (MosLink * pElm = pThd->mtxQ.pNext; pElm != &pThd->mtxQ; pElm = pElmSave) {
+        pElmSave = pElm->pNext;
+        MosRwLock * pLock = container_of(pElm, MosOwnLink, link)->pRwLock;
+        if (pLock) {
+            u32 access = (pElm == &pLock->writer.ownLink.link) ? RWLOCK_WRITER : 0;
+            ReleaseRwLock(pLock, pThd, access);
+        }
+    }
+}
+
+// Take lock if available, otherwise wait to be handed the lock.
+//   Writers have preference: new readers wait behind any queued thread.
+static bool WaitForRwLock(MosRwLock * pLock, u32 access, bool timed) {
+    LockScheduler(IntPriMaskLow);
+    u32 state = pLock->state;
+    // Waiters may have been killed
+    if (mosIsListEmpty(&pLock->pendQ.list)) state &= ~RWLOCK_WAITING;
+    if (access == RWLOCK_WRITER ? state == 0 :
+                                  !(state & (RWLOCK_WRITER | RWLOCK_WAITING))) {
+        pLock->state = (access == RWLOCK_WRITER) ? RWLOCK_WRITER : state + 1;
+        AddRwLockHold(pLock, pRunningThread, access);
+        UnlockScheduler();
+        asm volatile ( "dmb" );
+        return true;
+    }
+    pRunningThread->evtOpts = access;
+    SortThreadByPriority(pRunningThread, &pLock->pendQ);
+    pLock->state = state | RWLOCK_WAITING;
+    // Priority inheritance to the writer or tracked readers
+    BoostRwLockHolders(pLock, pRunningThread->pri, 0);
+    pRunningThread->timedOut = 0;
+    pRunningThread->pBlockedOn = pLock;
+    SetThreadState(pRunningThread, timed ? THREAD_WAIT_FOR_RWLOCK_OR_TICK :
+                                           THREAD_WAIT_FOR_RWLOCK);
+    YieldThread();
+    UnlockScheduler();
+    // Lock is handed over on wake up unless timed out
+    if (pRunningThread->timedOut) {
+        // A queued writer may have been holding back readers
+        LockScheduler(IntPriMaskLow);
+        GrantRwLock(pLock);
+        UnlockScheduler();
+        return false;
+    }
+    asm volatile ( "dmb" );
+    return true;
+}
+
+static void UnlockRwLock(MosRwLock * pLock, u32 access) {
+    asm volatile ( "dmb" );
+    LockScheduler(IntPriMaskLow);
+    ReleaseRwLock(pLock, pRunningThread, access);
+    if (pRunningThread->pri != pRunningThread->nomPri)
+        RestoreInheritedPriority(pRunningThread);
+    UnlockScheduler();
+}
+
+void mosReadLock(MosRwLock * pLock) {
+    WaitForRwLock(pLock, 0, false);
+}
+
+bool mosReadLockOrTO(MosRwLock * pLock, u32 ticks) {
+    SetTimeout(ticks);
+    return WaitForRwLock(pLock, 0, true);
+}
+
+void mosReadUnlock(MosRwLock * pLock) {
+    UnlockRwLock(pLock, 0);
+}
+
+void mosWriteLock(MosRwLock * pLock) {
+    WaitForRwLock(pLock, RWLOCK_WRITER, false);
+}
+
+bool mosWriteLockOrTO(MosRwLock * pLock, u32 ticks) {
+    SetTimeout(ticks);
+    return WaitForRwLock(pLock, RWLOCK_WRITER, true);
+}
+
+void mosWriteUnlock(MosRwLock * pLock) {
+    UnlockRwLock(pLock, RWLOCK_WRITER);
+}
+
 //
 // Semaphore
 //
 
 void mosInitSem(MosSem * pSem, u32 startValue) {
     pSem->value = startValue;
-    mosInitList(&pSem->pendQ);
+    InitPendQ(&pSem->pendQ);
     mosInitList(&pSem->evtLink);
+    pSem->pMember = NULL;
+}
+
+MOS_ISR_SAFE u32 mosTrySemCount(MosSem * pSem, u32 maxCount) {
+    u32 mask = mosDisableInterrupts();
+#if (MOS_ARCH_CAT == MOS_ARCH_ARM_CORTEX_M_BASE)
+    RewindRas();
+#endif
+    u32 count = (pSem->value < maxCount) ? pSem->value : maxCount;
+    pSem->value -= count;
+    asm volatile ( "dmb" );
+    mosEnableInterrupts(mask);
+    return count;
+}
+
+MOS_ISR_SAFE void mosAddToSem(MosSem * pSem, u32 count) {
+    if (count == 0) return;
+    u32 mask = mosDisableInterrupts();
+#if (MOS_ARCH_CAT == MOS_ARCH_ARM_CORTEX_M_BASE)
+    RewindRas();
+#endif
+    pSem->value += count;
+    asm volatile ( "dmb" );
+    if (pSem->pMember) QueueWaitSetMember(pSem->pMember);
+    // Scheduler releases as many pending threads as the count allows
+    if (!mosIsListEmpty(&pSem->pendQ.list) && !mosIsOnList(&pSem->evtLink)) {
+        PostISREvent(ISR_EVT_SEM, &pSem->evtLink);
+        Thread * pThd = container_of(pSem->pendQ.list.pNext, Thread, runLink);
+        // Yield if released thread has higher priority than running thread
+        if (pRunningThread && PreemptsRunningThread(pThd)) YieldThread();
+    }
+    mosEnableInterrupts(mask);
+}
+
+//
+// Event Groups
+//
+//   Like semaphores, setting flags only places the group on an event queue,
+//   all waiters are then resolved by the scheduler.
+
+void mosInitEventGroup(MosEventGroup * pGrp, u32 flags) {
+    pGrp->flags = flags;
+    InitPendQ(&pGrp->pendQ);
+    mosInitList(&pGrp->evtLink);
+}
+
+MOS_ISR_SAFE void mosSetEventFlags(MosEventGroup * pGrp, u32 flags) {
+    u32 mask = mosDisableInterrupts();
+    pGrp->flags |= flags;
+    // Only add event if pendQ is not empty and event not already queued
+    if (!mosIsListEmpty(&pGrp->pendQ.list) && !mosIsOnList(&pGrp->evtLink)) {
+        PostISREvent(ISR_EVT_EVENT_GROUP, &pGrp->evtLink);
+        Thread * pThd = container_of(pGrp->pendQ.list.pNext, Thread, runLink);
+        // Yield if highest priority waiter has higher priority than running thread
+        if (pRunningThread && PreemptsRunningThread(pThd)) YieldThread();
+    }
+    mosEnableInterrupts(mask);
+}
+
+MOS_ISR_SAFE void mosClearEventFlags(MosEventGroup * pGrp, u32 flags) {
+    u32 mask = mosDisableInterrupts();
+    pGrp->flags &= ~flags;
+    mosEnableInterrupts(mask);
+}
+
+MOS_ISR_SAFE u32 mosGetEventFlags(MosEventGroup * pGrp) {
+    return pGrp->flags;
+}
+
+// Take flags if wait condition is satisfied, must disable interrupts before calling
+static MOS_INLINE u32 TakeEventFlags(MosEventGroup * pGrp, u32 mask, u32 opts) {
+    if (!EventFlagsMatch(pGrp->flags, mask, opts)) return 0;
+    u32 flags = pGrp->flags & mask;
+    if (opts & MOS_EVENT_GROUP_AUTO_CLEAR) pGrp->flags &= ~flags;
+    return flags;
+}
+
+static u32 WaitForEventFlags(MosEventGroup * pGrp, u32 mask, u32 opts, ThreadState state) {
+    // No flags could ever satisfy an empty mask
+    mosAssert(mask != 0);
+    _mosDisableInterrupts();
+    u32 flags = TakeEventFlags(pGrp, mask, opts);
+    if (flags == 0) {
+        SortThreadByPriority(pRunningThread, &pGrp->pendQ);
+        pRunningThread->evtMask = mask;
+        pRunningThread->evtOpts = opts;
+        pRunningThread->timedOut = 0;
+        pRunningThread->pBlockedOn = pGrp;
+        SetThreadState(pRunningThread, state);
+        YieldThread();
+        // Must enable interrupts to allow pend
+        _mosEnableInterruptsWithBarrier();
+        _mosDisableInterrupts();
+        // Scheduler places matched flags in evtMask, on timeout the
+        //   flags might have been set in the meantime so check again.
+        if (pRunningThread->timedOut) flags = TakeEventFlags(pGrp, mask, opts);
+        else flags = pRunningThread->evtMask;
+    }
+    _mosEnableInterrupts();
+    return flags;
+}
+
+u32 mosWaitForEventFlags(MosEventGroup * pGrp, u32 mask, u32 opts) {
+    return WaitForEventFlags(pGrp, mask, opts, THREAD_WAIT_FOR_EVENT_GROUP);
+}
+
+u32 mosWaitForEventFlagsOrTO(MosEventGroup * pGrp, u32 mask, u32 opts, u32 ticks) {
+    SetTimeout(ticks);
+    return WaitForEventFlags(pGrp, mask, opts, THREAD_WAIT_FOR_EVENT_GROUP_OR_TICK);
+}
+
+//
+// Direct-to-thread Notifications
+//
+//   Waiting threads are not on any list, so notifiers place the thread itself
+//   on the notify queue to be made runnable by the scheduler.
+
+MOS_ISR_SAFE void mosNotifyThread(MosThread * _pThd, u32 value, MosNotifyAction action) {
+    Thread * pThd = (Thread *)_pThd;
+    u32 mask = mosDisableInterrupts();
+    switch (action) {
+    case MOS_NOTIFY_SET_BITS:
+        pThd->notifyValue |= value;
+        break;
+    case MOS_NOTIFY_INCREMENT:
+        pThd->notifyValue++;
+        break;
+    case MOS_NOTIFY_OVERWRITE:
+        pThd->notifyValue = value;
+        break;
+    }
+    pThd->notifyPend = 1;
+    if ((pThd->state == THREAD_WAIT_FOR_NOTIFY || pThd->state == THREAD_WAIT_FOR_NOTIFY_OR_TICK) &&
+            !mosIsOnList(&pThd->runLink)) {
+        PostISREvent(ISR_EVT_NOTIFY, &pThd->runLink);
+        // Yield if notified thread has higher priority than running thread
+        if (pRunningThread && PreemptsRunningThread(pThd)) YieldThread();
+    }
+    mosEnableInterrupts(mask);
+}
+
+static bool WaitForNotify(u32 clearMask, u32 * pValue, ThreadState state) {
+    _mosDisableInterrupts();
+    // Block unless notification is already pending
+    if (!pRunningThread->notifyPend) {
+        RemoveThreadFromList(pRunningThread);
+        pRunningThread->timedOut = 0;
+        SetThreadState(pRunningThread, state);
+        YieldThread();
+        // Must enable interrupts to allow pend
+        _mosEnableInterruptsWithBarrier();
+        _mosDisableInterrupts();
+    }
+    bool notified = pRunningThread->notifyPend;
+    if (notified) {
+        *pValue = pRunningThread->notifyValue;
+        pRunningThread->notifyValue &= ~clearMask;
+        pRunningThread->notifyPend = 0;
+    }
+    _mosEnableInterrupts();
+    return notified;
+}
+
+u32 mosWaitForNotify(u32 clearMask) {
+    u32 value = 0;
+    while (!WaitForNotify(clearMask, &value, THREAD_WAIT_FOR_NOTIFY));
+    return value;
+}
+
+bool mosWaitForNotifyOrTO(u32 clearMask, u32 * pValue, u32 ticks) {
+    SetTimeout(ticks);
+    return WaitForNotify(clearMask, pValue, THREAD_WAIT_FOR_NOTIFY_OR_TICK);
+}
+
+//
+// ISR Events
+//
+
+void mosInitISREvent(MosISREvent * pEvt, MosISREventHandler * pHandler) {
+    mosInitList(&pEvt->evtLink);
+    pEvt->pHandler = pHandler;
+}
+
+MOS_ISR_SAFE void mosPostISREvent(MosISREvent * pEvt) {
+    u32 mask = mosDisableInterrupts();
+    if (!mosIsOnList(&pEvt->evtLink)) {
+        PostISREvent(ISR_EVT_CALLBACK, &pEvt->evtLink);
+        YieldThread();
+    }
+    mosEnableInterrupts(mask);
+}
+
+//
+// Wait Sets
+//
+//   Members are queued on the ready queue of their set by the kernel object
+//   as it becomes ready, and the set semaphore counts the queued members.
+//
+
+void mosInitWaitSet(MosWaitSet * pSet) {
+    mosInitSem(&pSet->sem, 0);
+    mosInitList(&pSet->readyQ);
+    pSet->pLast = NULL;
+}
+
+static void AddToWaitSet(MosWaitSet * pSet, MosWaitSetMember * pMember,
+                         WaitSetMemberType type, void * pObj) {
+    mosInitList(&pMember->readyLink);
+    pMember->pSet = pSet;
+    pMember->pObj = pObj;
+    pMember->type = type;
+}
+
+void mosAddSemToWaitSet(MosWaitSet * pSet, MosWaitSetMember * pMember, MosSem * pSem) {
+    AddToWaitSet(pSet, pMember, WAIT_SET_SEM, pSem);
+    u32 mask = mosDisableInterrupts();
+    mosAssert(pSem->pMember == NULL);
+    pSem->pMember = pMember;
+    if (pSem->value) QueueWaitSetMember(pMember);
+    mosEnableInterrupts(mask);
+}
+
+void mosAddThreadToWaitSet(MosWaitSet * pSet, MosWaitSetMember * pMember, MosThread * _pThd) {
+    Thread * pThd = (Thread *)_pThd;
+    AddToWaitSet(pSet, pMember, WAIT_SET_THREAD, pThd);
+    LockScheduler(IntPriMaskLow);
+    mosAssert(pThd->pStopMember == NULL);
+    pThd->pStopMember = pMember;
+    if (pThd->state <= THREAD_STOPPED) {
+        u32 mask = mosDisableInterrupts();
+        QueueWaitSetMember(pMember);
+        mosEnableInterrupts(mask);
+    }
+    UnlockScheduler();
+}
+
+MOS_ISR_SAFE static bool WaitSetTimerCallback(MosTimer * pTmr) {
+    u32 mask = mosDisableInterrupts();
+    if (pTmr->pMember) QueueWaitSetMember(pTmr->pMember);
+    mosEnableInterrupts(mask);
+    return true;
+}
+
+void mosAddTimerToWaitSet(MosWaitSet * pSet, MosWaitSetMember * pMember, MosTimer * pTmr) {
+    AddToWaitSet(pSet, pMember, WAIT_SET_TIMER, pTmr);
+    LockScheduler(IntPriMaskLow);
+    mosAssert(pTmr->pMember == NULL);
+    pMember->pTmrCallback = pTmr->pCallback;
+    pTmr->pCallback = WaitSetTimerCallback;
+    pTmr->pMember = pMember;
+    UnlockScheduler();
+}
+
+void mosRemoveFromWaitSet(MosWaitSetMember * pMember) {
+    LockScheduler(IntPriMaskLow);
+    u32 mask = mosDisableInterrupts();
+    if (pMember->type == WAIT_SET_SEM) ((MosSem *)pMember->pObj)->pMember = NULL;
+    else if (pMember->type == WAIT_SET_THREAD) ((Thread *)pMember->pObj)->pStopMember = NULL;
+    else if (pMember->type == WAIT_SET_TIMER) {
+        MosTimer * pTmr = (MosTimer *)pMember->pObj;
+        pTmr->pMember = NULL;
+        pTmr->pCallback = pMember->pTmrCallback;
+    }
+    MosWaitSet * pSet = pMember->pSet;
+    pMember->pSet = NULL;
+    if (pSet && pSet->pLast == pMember) pSet->pLast = NULL;
+    if (mosIsOnList(&pMember->readyLink)) {
+        mosRemoveFromList(&pMember->readyLink);
+        // A waiter that already took the count finds the queue empty and retries
+        mosTrySem(&pSet->sem);
+    }
+    mosEnableInterrupts(mask);
+    UnlockScheduler();
+}
+
+// Requeue semaphore member last returned if still ready
+MOS_ISR_SAFE static void RequeueLastMember(MosWaitSet * pSet) {
+    u32 mask = mosDisableInterrupts();
+    MosWaitSetMember * pMember = pSet->pLast;
+    if (pMember && pMember->type == WAIT_SET_SEM && ((MosSem *)pMember->pObj)->value)
+        QueueWaitSetMember(pMember);
+    pSet->pLast = NULL;
+    mosEnableInterrupts(mask);
+}
+
+MOS_ISR_SAFE static MosWaitSetMember * TakeReadyMember(MosWaitSet * pSet) {
+    MosWaitSetMember * pMember = NULL;
+    u32 mask = mosDisableInterrupts();
+    if (!mosIsListEmpty(&pSet->readyQ)) {
+        pMember = container_of(pSet->readyQ.pNext, MosWaitSetMember, readyLink);
+        mosRemoveFromList(&pMember->readyLink);
+        pSet->pLast = pMember;
+    }
+    mosEnableInterrupts(mask);
+    return pMember;
+}
+
+MosWaitSetMember * mosWaitOnWaitSet(MosWaitSet * pSet) {
+    RequeueLastMember(pSet);
+    while (1) {
+        mosWaitForSem(&pSet->sem);
+        MosWaitSetMember * pMember = TakeReadyMember(pSet);
+        if (pMember) return pMember;
+    }
+}
+
+MosWaitSetMember * mosWaitOnWaitSetOrTO(MosWaitSet * pSet, u32 ticks) {
+    RequeueLastMember(pSet);
+    u32 start = mosGetTickCount();
+    while (1) {
+        u32 elapsed = mosGetTickCount() - start;
+        if (elapsed >= ticks || !mosWaitForSemOrTO(&pSet->sem, ticks - elapsed)) return NULL;
+        MosWaitSetMember * pMember = TakeReadyMember(pSet);
+        if (pMember) return pMember;
+    }
+}
+
+MOS_ISR_SAFE MosWaitSetMember * mosPollWaitSet(MosWaitSet * pSet) {
+    RequeueLastMember(pSet);
+    if (!mosTrySem(&pSet->sem)) return NULL;
+    return TakeReadyMember(pSet);
 }
 
 //
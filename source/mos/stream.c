@@ -0,0 +1,313 @@
+// Copyright 2021-2023 Matthew C Needes
+// You may not use this source file except in compliance with the
+// terms and conditions contained within the LICENSE file (the
+// "License") included under this distribution.
+
+//
+// MOS Stream and Message Buffers
+//
+
+#include <string.h>
+
+#include <mos/stream.h>
+
+// Tail is only written by the writer and head only by the reader, so the
+// indices themselves need no locking.  Signals wake a blocked reader or
+// writer, and since they latch, a wake-up is not lost if raised before the
+// other side blocks.
+
+#define MSG_HDR_SIZE     2
+#define MSG_WRAP_MARKER  0xFFFF
+
+MOS_ISR_SAFE static MOS_INLINE u32 Advance(MosStreamBuffer * pStream, u32 ix, u32 len) {
+    ix += len;
+    if (ix >= pStream->size) ix -= pStream->size;
+    return ix;
+}
+
+MOS_ISR_SAFE static MOS_INLINE u32 Count(MosStreamBuffer * pStream, u32 tail, u32 head) {
+    return (tail >= head) ? tail - head : tail + pStream->size - head;
+}
+
+MOS_ISR_SAFE static MOS_INLINE u32 Space(MosStreamBuffer * pStream, u32 tail, u32 head) {
+    return pStream->size - 1 - Count(pStream, tail, head);
+}
+
+MOS_ISR_SAFE static void CommitWrite(MosStreamBuffer * pStream, u32 tail) {
+    asm volatile ( "dmb" );
+    pStream->tail = tail;
+    if (Count(pStream, tail, pStream->head) >= pStream->trigger)
+        mosRaiseSignal(&pStream->sigData, 1);
+}
+
+MOS_ISR_SAFE static void ReleaseRead(MosStreamBuffer * pStream, u32 head) {
+    asm volatile ( "dmb" );
+    pStream->head = head;
+    mosRaiseSignal(&pStream->sigSpace, 1);
+}
+
+// Wait for signal, or for what remains of ticks since start if timed
+static bool WaitForSignal(MosSignal * pSignal, bool timed, u32 start, u32 ticks) {
+    if (!timed) {
+        mosWaitForSignal(pSignal);
+        return true;
+    }
+    u32 elapsed = mosGetTickCount() - start;
+    if (elapsed >= ticks) return false;
+    return mosWaitForSignalOrTO(pSignal, ticks - elapsed) != 0;
+}
+
+//
+// Stream Buffers
+//
+
+void mosInitStreamBuffer(MosStreamBuffer * pStream, void * pBuffer, u32 size, u32 trigger) {
+    mosAssert(size > 1);
+    pStream->pBuf = (u8 *)pBuffer;
+    pStream->size = size;
+    pStream->tail = 0;
+    pStream->head = 0;
+    mosSetStreamBufferTrigger(pStream, trigger);
+    mosInitSignal(&pStream->sigData, 0);
+    mosInitSignal(&pStream->sigSpace, 0);
+}
+
+void mosSetStreamBufferTrigger(MosStreamBuffer * pStream, u32 trigger) {
+    if (trigger == 0) trigger = 1;
+    else if (trigger > pStream->size - 1) trigger = pStream->size - 1;
+    pStream->trigger = trigger;
+}
+
+MOS_ISR_SAFE u32 mosGetStreamBufferCount(MosStreamBuffer * pStream) {
+    return Count(pStream, pStream->tail, pStream->head);
+}
+
+MOS_ISR_SAFE u32 mosGetStreamBufferSpace(MosStreamBuffer * pStream) {
+    return Space(pStream, pStream->tail, pStream->head);
+}
+
+MOS_ISR_SAFE u32 mosTryWriteToStreamBuffer(MosStreamBuffer * pStream, const void * pData, u32 len) {
+    u32 tail = pStream->tail;
+    u32 space = Space(pStream, tail, pStream->head);
+    if (len > space) len = space;
+    if (len == 0) return 0;
+    // Copy up to end of ring, then remainder from start
+    u32 first = pStream->size - tail;
+    if (first > len) first = len;
+    memcpy(pStream->pBuf + tail, pData, first);
+    memcpy(pStream->pBuf, (const u8 *)pData + first, len - first);
+    CommitWrite(pStream, Advance(pStream, tail, len));
+    return len;
+}
+
+static u32 WriteStream(MosStreamBuffer * pStream, const u8 * pData, u32 len,
+                       bool timed, u32 ticks) {
+    u32 start = mosGetTickCount();
+    u32 written = 0;
+    while (1) {
+        written += mosTryWriteToStreamBuffer(pStream, pData + written, len - written);
+        if (written == len) break;
+        if (!WaitForSignal(&pStream->sigSpace, timed, start, ticks)) break;
+    }
+    return written;
+}
+
+void mosWriteToStreamBuffer(MosStreamBuffer * pStream, const void * pData, u32 len) {
+    WriteStream(pStream, pData, len, false, 0);
+}
+
+u32 mosWriteToStreamBufferOrTO(MosStreamBuffer * pStream, const void * pData, u32 len, u32 ticks) {
+    return WriteStream(pStream, pData, len, true, ticks);
+}
+
+MOS_ISR_SAFE u32 mosTryReadFromStreamBuffer(MosStreamBuffer * pStream, void * pData, u32 len) {
+    u32 head = pStream->head;
+    u32 count = Count(pStream, pStream->tail, head);
+    if (len > count) len = count;
+    if (len == 0) return 0;
+    asm volatile ( "dmb" );
+    u32 first = pStream->size - head;
+    if (first > len) first = len;
+    memcpy(pData, pStream->pBuf + head, first);
+    memcpy((u8 *)pData + first, pStream->pBuf, len - first);
+    ReleaseRead(pStream, Advance(pStream, head, len));
+    return len;
+}
+
+static u32 ReadStream(MosStreamBuffer * pStream, void * pData, u32 len,
+                      bool timed, u32 ticks) {
+    u32 start = mosGetTickCount();
+    while (mosGetStreamBufferCount(pStream) < pStream->trigger) {
+        if (!WaitForSignal(&pStream->sigData, timed, start, ticks)) break;
+    }
+    return mosTryReadFromStreamBuffer(pStream, pData, len);
+}
+
+u32 mosReadFromStreamBuffer(MosStreamBuffer * pStream, void * pData, u32 len) {
+    return ReadStream(pStream, pData, len, false, 0);
+}
+
+u32 mosReadFromStreamBufferOrTO(MosStreamBuffer * pStream, void * pData, u32 len, u32 ticks) {
+    return ReadStream(pStream, pData, len, true, ticks);
+}
+
+MOS_ISR_SAFE u32 mosGetStreamBufferWriteRegion(MosStreamBuffer * pStream, void ** ppRegion) {
+    u32 tail = pStream->tail;
+    u32 space = Space(pStream, tail, pStream->head);
+    u32 contig = pStream->size - tail;
+    *ppRegion = pStream->pBuf + tail;
+    return (space < contig) ? space : contig;
+}
+
+MOS_ISR_SAFE void mosCommitStreamBufferWrite(MosStreamBuffer * pStream, u32 len) {
+    CommitWrite(pStream, Advance(pStream, pStream->tail, len));
+}
+
+MOS_ISR_SAFE u32 mosGetStreamBufferReadRegion(MosStreamBuffer * pStream, const void ** ppRegion) {
+    u32 head = pStream->head;
+    u32 count = Count(pStream, pStream->tail, head);
+    u32 contig = pStream->size - head;
+    asm volatile ( "dmb" );
+    *ppRegion = pStream->pBuf + head;
+    return (count < contig) ? count : contig;
+}
+
+MOS_ISR_SAFE void mosReleaseStreamBufferRead(MosStreamBuffer * pStream, u32 len) {
+    ReleaseRead(pStream, Advance(pStream, pStream->head, len));
+}
+
+//
+// Message Buffers
+//
+//   Messages never wrap.  If a message does not fit before the end of the
+//   ring the remaining bytes are skipped, marked by a wrap marker if there
+//   is room for one.  Headers are accessed by byte as they are unaligned.
+//
+
+MOS_ISR_SAFE static MOS_INLINE u32 GetHeader(const u8 * pHdr) {
+    return pHdr[0] | (pHdr[1] << 8);
+}
+
+MOS_ISR_SAFE static MOS_INLINE void SetHeader(u8 * pHdr, u32 value) {
+    pHdr[0] = value & 0xFF;
+    pHdr[1] = value >> 8;
+}
+
+// Locate next message, returning offset of its header
+MOS_ISR_SAFE static bool FindMessage(MosStreamBuffer * pStream, u32 * pHead) {
+    u32 head = pStream->head;
+    if (head == pStream->tail) return false;
+    asm volatile ( "dmb" );
+    if (pStream->size - head < MSG_HDR_SIZE ||
+            GetHeader(pStream->pBuf + head) == MSG_WRAP_MARKER) head = 0;
+    *pHead = head;
+    return true;
+}
+
+void mosInitMessageBuffer(MosMessageBuffer * pMsgBuf, void * pBuffer, u32 size) {
+    mosInitStreamBuffer(&pMsgBuf->sb, pBuffer, size, 1);
+    pMsgBuf->resvTail = 0;
+}
+
+MOS_ISR_SAFE u32 mosGetMaxMessageSize(MosMessageBuffer * pMsgBuf) {
+    // Worst case a skipped region precedes a message in an empty buffer
+    u32 max = (pMsgBuf->sb.size - 1) / 2;
+    if (max <= MSG_HDR_SIZE) return 0;
+    max -= MSG_HDR_SIZE;
+    return (max < MSG_WRAP_MARKER) ? max : MSG_WRAP_MARKER - 1;
+}
+
+MOS_ISR_SAFE void * mosTryReserveMessage(MosMessageBuffer * pMsgBuf, u32 len) {
+    MosStreamBuffer * pStream = &pMsgBuf->sb;
+    u32 tail = pStream->tail;
+    u32 need = MSG_HDR_SIZE + len;
+    u32 skip = 0;
+    if (len == 0 || len >= MSG_WRAP_MARKER) return NULL;
+    if (tail + need > pStream->size) skip = pStream->size - tail;
+    if (skip + need > Space(pStream, tail, pStream->head)) return NULL;
+    if (skip) {
+        if (skip >= MSG_HDR_SIZE) SetHeader(pStream->pBuf + tail, MSG_WRAP_MARKER);
+        tail = 0;
+    }
+    SetHeader(pStream->pBuf + tail, len);
+    pMsgBuf->resvTail = Advance(pStream, tail, need);
+    return pStream->pBuf + tail + MSG_HDR_SIZE;
+}
+
+MOS_ISR_SAFE void mosCommitMessage(MosMessageBuffer * pMsgBuf) {
+    CommitWrite(&pMsgBuf->sb, pMsgBuf->resvTail);
+}
+
+MOS_ISR_SAFE const void * mosTryPeekMessage(MosMessageBuffer * pMsgBuf, u32 * pLen) {
+    MosStreamBuffer * pStream = &pMsgBuf->sb;
+    u32 head;
+    if (!FindMessage(pStream, &head)) return NULL;
+    *pLen = GetHeader(pStream->pBuf + head);
+    return pStream->pBuf + head + MSG_HDR_SIZE;
+}
+
+MOS_ISR_SAFE void mosReleaseMessage(MosMessageBuffer * pMsgBuf) {
+    MosStreamBuffer * pStream = &pMsgBuf->sb;
+    u32 head;
+    if (!FindMessage(pStream, &head)) return;
+    u32 len = GetHeader(pStream->pBuf + head);
+    ReleaseRead(pStream, Advance(pStream, head, MSG_HDR_SIZE + len));
+}
+
+MOS_ISR_SAFE u32 mosGetNextMessageSize(MosMessageBuffer * pMsgBuf) {
+    u32 len = 0;
+    mosTryPeekMessage(pMsgBuf, &len);
+    return len;
+}
+
+MOS_ISR_SAFE bool mosTrySendToMessageBuffer(MosMessageBuffer * pMsgBuf, const void * pData, u32 len) {
+    void * pMsg = mosTryReserveMessage(pMsgBuf, len);
+    if (pMsg == NULL) return false;
+    memcpy(pMsg, pData, len);
+    mosCommitMessage(pMsgBuf);
+    return true;
+}
+
+static bool SendMessage(MosMessageBuffer * pMsgBuf, const void * pData, u32 len,
+                        bool timed, u32 ticks) {
+    if (len == 0 || len > mosGetMaxMessageSize(pMsgBuf)) return false;
+    u32 start = mosGetTickCount();
+    while (!mosTrySendToMessageBuffer(pMsgBuf, pData, len)) {
+        if (!WaitForSignal(&pMsgBuf->sb.sigSpace, timed, start, ticks)) return false;
+    }
+    return true;
+}
+
+bool mosSendToMessageBuffer(MosMessageBuffer * pMsgBuf, const void * pData, u32 len) {
+    return SendMessage(pMsgBuf, pData, len, false, 0);
+}
+
+bool mosSendToMessageBufferOrTO(MosMessageBuffer * pMsgBuf, const void * pData, u32 len, u32 ticks) {
+    return SendMessage(pMsgBuf, pData, len, true, ticks);
+}
+
+MOS_ISR_SAFE u32 mosTryReceiveFromMessageBuffer(MosMessageBuffer * pMsgBuf, void * pData, u32 maxLen) {
+    u32 len;
+    const void * pMsg = mosTryPeekMessage(pMsgBuf, &len);
+    if (pMsg == NULL || len > maxLen) return 0;
+    memcpy(pData, pMsg, len);
+    mosReleaseMessage(pMsgBuf);
+    return len;
+}
+
+static u32 ReceiveMessage(MosMessageBuffer * pMsgBuf, void * pData, u32 maxLen,
+                          bool timed, u32 ticks) {
+    u32 start = mosGetTickCount();
+    while (mosGetNextMessageSize(pMsgBuf) == 0) {
+        if (!WaitForSignal(&pMsgBuf->sb.sigData, timed, start, ticks)) return 0;
+    }
+    return mosTryReceiveFromMessageBuffer(pMsgBuf, pData, maxLen);
+}
+
+u32 mosReceiveFromMessageBuffer(MosMessageBuffer * pMsgBuf, void * pData, u32 maxLen) {
+    return ReceiveMessage(pMsgBuf, pData, maxLen, false, 0);
+}
+
+u32 mosReceiveFromMessageBufferOrTO(MosMessageBuffer * pMsgBuf, void * pData, u32 maxLen, u32 ticks) {
+    return ReceiveMessage(pMsgBuf, pData, maxLen, true, ticks);
+}